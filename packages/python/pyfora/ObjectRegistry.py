@@ -34,6 +34,10 @@ class ObjectRegistry(object):
             primitive = base64.b64encode(primitive)
         self.objectIdToObjectDefinition[objectId] = primitive
 
+    def definePackedHomogenousData(self, objectId, dtype, data):
+        self.objectIdToObjectDefinition[objectId] = \
+            TypeDescription.PackedHomogenousData(dtype, base64.b64encode(data))
+
     def defineTuple(self, objectId, memberIds):
         self.objectIdToObjectDefinition[objectId] = TypeDescription.Tuple(memberIds)
 
@@ -148,6 +152,7 @@ class ObjectRegistry(object):
                 isinstance(objectDefinition,
                            (TypeDescription.File, TypeDescription.RemotePythonObject,
                             TypeDescription.NamedSingleton, list,
+                            TypeDescription.PackedHomogenousData,
                             TypeDescription.Unconvertible)):
             return []
         elif isinstance(objectDefinition, (TypeDescription.BuiltinExceptionInstance)):
@@ -0,0 +1,59 @@
+#   Copyright 2015 Ufora Inc.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import numpy
+
+
+class PackedHomogenousData(object):
+    """
+    A flat, C-contiguous numpy array of bools, int64s or float64s that should
+    be shipped to the server as a single packed buffer rather than as a list
+    of individually-encoded primitives. The server turns it into a FORA vector
+    without ever materializing python values for its elements.
+    """
+    dtypeNames = {
+        numpy.dtype('bool'): 'bool',
+        numpy.dtype('int64'): 'int64',
+        numpy.dtype('float64'): 'float64'
+        }
+
+    def __init__(self, array):
+        assert array.ndim == 1 and array.dtype in self.dtypeNames
+        self.array = numpy.ascontiguousarray(array)
+
+    @property
+    def dtype(self):
+        return self.dtypeNames[self.array.dtype]
+
+    def tostring(self):
+        return self.array.tostring()
+
+    @staticmethod
+    def canPack(array):
+        """Can we pack 'array' without changing the values python would see?"""
+        kind = array.dtype.kind
+        return kind in 'bif' or (kind == 'u' and array.dtype.itemsize < 8)
+
+    @staticmethod
+    def fromArray(array):
+        """Flatten and pack a numpy array. Assumes `canPack(array)`."""
+        kind = array.dtype.kind
+        if kind == 'b':
+            target = numpy.bool_
+        elif kind == 'f':
+            target = numpy.float64
+        else:
+            target = numpy.int64
+
+        return PackedHomogenousData(array.flatten().astype(target, copy=False))
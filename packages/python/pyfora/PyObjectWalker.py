@@ -19,6 +19,7 @@ import pyfora.Future as Future
 import pyfora.NamedSingletons as NamedSingletons
 import pyfora.PyforaWithBlock as PyforaWithBlock
 import pyfora.PyforaInspect as PyforaInspect
+import pyfora.PackedHomogenousData as PackedHomogenousData
 import pyfora.pyAst.PyAstUtil as PyAstUtil
 from pyfora.TypeDescription import isPrimitive
 from pyfora.PyforaInspect import PyforaInspectError
@@ -217,6 +218,8 @@ class PyObjectWalker(object):
             self._registerWithBlock(objectId, pyObject)
         elif isinstance(pyObject, _Unconvertible):
             self._registerUnconvertible(objectId)
+        elif isinstance(pyObject, PackedHomogenousData.PackedHomogenousData):
+            self._registerPackedHomogenousData(objectId, pyObject)
         elif isinstance(pyObject, tuple):
             self._registerTuple(objectId, pyObject)
         elif isinstance(pyObject, list):
@@ -320,6 +323,17 @@ class PyObjectWalker(object):
             primitive
             )
 
+    def _registerPackedHomogenousData(self, objectId, packedData):
+        """
+        `_registerPackedHomogenousData`: register a `PackedHomogenousData`
+        (a terminal node in a python object graph) with `self.objectRegistry`
+        """
+        self._objectRegistry.definePackedHomogenousData(
+            objectId,
+            packedData.dtype,
+            packedData.tostring()
+            )
+
     def _registerDict(self, objectId, dict_):
         """
         `_registerDict`: register a `dict` instance
@@ -158,16 +158,21 @@ class PythonObjectRehydrator(object):
                 stringsAndSizes = objectDef['homogenousListNumpyDataStringsAndSizes']
 
                 dtype = cPickle.loads(base64.b64decode(objectDef['dtype']))
-                data = numpy.zeros(shape=objectDef['length'], dtype=dtype)
-
-                curOffset = 0
-                for dataAndSize in stringsAndSizes:
-                    arrayText = dataAndSize['data']
-                    size = dataAndSize['length']
-                    data[curOffset:curOffset+size] = numpy.ndarray(shape=size,
-                                                                   dtype=dtype,
-                                                                   buffer=base64.b64decode(arrayText))
-                    curOffset += size
+
+                if len(stringsAndSizes) == 1:
+                    #no need to copy into a separate array if there's only one chunk
+                    data = numpy.frombuffer(base64.b64decode(stringsAndSizes[0]['data']), dtype=dtype)
+                else:
+                    data = numpy.zeros(shape=objectDef['length'], dtype=dtype)
+
+                    curOffset = 0
+                    for dataAndSize in stringsAndSizes:
+                        arrayText = dataAndSize['data']
+                        size = dataAndSize['length']
+                        data[curOffset:curOffset+size] = numpy.ndarray(shape=size,
+                                                                       dtype=dtype,
+                                                                       buffer=base64.b64decode(arrayText))
+                        curOffset += size
 
                 #we use the first element as a prototype when decoding
                 firstElement = convert(objectDef['firstElement'])
@@ -108,6 +108,10 @@ InstanceMethod = type_description(
     'InstanceMethod',
     'instanceId, methodName'
     )
+PackedHomogenousData = type_description(
+    'PackedHomogenousData',
+    'dtype, dataAsBase64'
+    )
 Unconvertible = type_description(
     'Unconvertible',
     ''
@@ -16,6 +16,7 @@
 from pyfora.PureImplementationMapping import PureImplementationMapping, pureMapping
 import pyfora.pure_modules.pure_math as PureMath
 from pyfora.pure_modules.pure___builtin__ import Round
+from pyfora.PackedHomogenousData import PackedHomogenousData
 
 import math
 import numpy as np
@@ -229,6 +230,14 @@ class PurePythonNumpyArrayMapping(PureImplementationMapping):
         return [PurePythonNumpyArray]
 
     def mapPythonInstanceToPyforaInstance(self, numpyArray):
+        if PackedHomogenousData.canPack(numpyArray):
+            # ship the raw buffer; the server builds the values list from it
+            # directly instead of us encoding each element
+            return PurePythonNumpyArray(
+                numpyArray.shape,
+                PackedHomogenousData.fromArray(numpyArray)
+                )
+
         return PurePythonNumpyArray(
             numpyArray.shape,
             numpyArray.flatten().tolist()
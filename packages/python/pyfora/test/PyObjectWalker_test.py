@@ -16,7 +16,12 @@ import pyfora.PureImplementationMappings as PureImplementationMappings
 import pyfora.PureImplementationMapping as PureImplementationMapping
 import pyfora.PyObjectWalker as PyObjectWalker
 import pyfora.NamedSingletons as NamedSingletons
+import pyfora.ObjectRegistry as ObjectRegistry
+import pyfora.TypeDescription as TypeDescription
+from pyfora.PackedHomogenousData import PackedHomogenousData
 
+import base64
+import numpy
 import unittest
 
 class SomeRandomInstance:
@@ -60,6 +65,29 @@ class PyObjectWalkerTest(unittest.TestCase):
                 objectRegistry=None
                 )
 
+    def test_packed_homogenous_data_is_registered_as_a_buffer(self):
+        registry = ObjectRegistry.ObjectRegistry()
+        walker = PyObjectWalker.PyObjectWalker(
+            purePythonClassMapping=PureImplementationMappings.PureImplementationMappings(),
+            objectRegistry=registry
+            )
+
+        array = numpy.arange(12, dtype=numpy.int32).reshape((3, 4))
+        self.assertTrue(PackedHomogenousData.canPack(array))
+
+        objectId = walker.walkPyObject(PackedHomogenousData.fromArray(array))
+        definition = registry.getDefinition(objectId)
+
+        self.assertIsInstance(definition, TypeDescription.PackedHomogenousData)
+        self.assertEqual(definition.dtype, 'int64')
+        self.assertEqual(
+            numpy.frombuffer(base64.b64decode(definition.dataAsBase64), dtype=numpy.int64).tolist(),
+            array.flatten().tolist()
+            )
+
+        self.assertFalse(PackedHomogenousData.canPack(numpy.array(['a', 'b'])))
+        self.assertFalse(PackedHomogenousData.canPack(numpy.zeros(3, dtype=numpy.uint64)))
+
 
 if __name__ == "__main__":
     unittest.main()
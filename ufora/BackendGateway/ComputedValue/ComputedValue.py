@@ -248,6 +248,52 @@ class ComputedValueVectorSlice(ComputedGraph.Location):
 
         return result
 
+    @ComputedGraph.Function
+    def extractVectorDataAsBase64InChunks(self, stepSize = 1000000):
+        """Return the data as a list of (base64String, elementCount) pairs.
+
+        Each string is the base64 encoding of the raw bytes of up to 'stepSize' elements, laid
+        out as a numpy array of dtype 'vectorNumpyDtype()'. The VDM encodes straight out of its
+        pages, so unlike 'extractVectorDataAsNumpyArrayInChunks' no intermediate arrays are built.
+        """
+        if self.computedValueVector.vectorImplVal is None:
+            return None
+
+        if len(self.vectorDataIds) > 0 and not self.isLoaded:
+            return None
+
+        if not self.vdmThinksIsLoaded():
+            return None
+
+        result = []
+        index = self.lowIndex
+        while index < self.highIndex and result is not None:
+            high = min(self.highIndex, index+stepSize)
+            tailResult = ComputedValueGateway.getGateway().extractVectorDataAsBase64(
+                self.computedValueVector,
+                index,
+                high
+                )
+            if tailResult is not None:
+                result.append((tailResult, high - index))
+            else:
+                result = None
+            index = high
+
+        if result is None and not self.vdmThinksIsLoaded():
+            logging.info("CumulusClient: %s was marked loaded but returned None", self)
+            self.isLoaded = False
+            ComputedValueGateway.getGateway().reloadVector(self)
+
+        return result
+
+    @ComputedGraph.Function
+    def vectorNumpyDtype(self):
+        if self.computedValueVector.vectorImplVal is None:
+            return None
+
+        return ComputedValueGateway.getGateway().vectorNumpyDtype(self.computedValueVector)
+
     @ComputedGraph.Function
     def extractVectorItemAsIVC(self, ct):
         if self.computedValueVector.vectorImplVal is None:
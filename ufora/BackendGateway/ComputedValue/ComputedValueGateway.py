@@ -77,6 +77,16 @@ class CacheLoader(object):
             high
             )
 
+    def extractVectorDataAsBase64(self, vectorCGLocation, low, high):
+        return self.vdm.extractVectorContentsAsBase64(
+            vectorCGLocation.vectorImplVal,
+            low,
+            high
+            )
+
+    def vectorNumpyDtype(self, vectorCGLocation):
+        return self.vdm.vectorNumpyDtype(vectorCGLocation.vectorImplVal)
+
     def extractVectorItem(self, vectorCGLocation, index):
         return self.vdm.extractVectorItem(
             vectorCGLocation.vectorImplVal,
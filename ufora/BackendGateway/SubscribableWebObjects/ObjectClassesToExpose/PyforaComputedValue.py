@@ -242,14 +242,18 @@ class PyforaResultAsJson(ComputedGraph.Location):
                         assert res is not None
                         return {'string': res.tostring()}
 
-                    #see if it's simple enough to transmit as numpy data
+                    #see if it's simple enough to transmit as raw numpy data
                     if len(vectorIVC.getVectorElementsJOR()) == 1 and len(vectorIVC) > 1:
-                        res = vdm.extractVectorContentsAsNumpyArray(vectorIVC, 0, len(vectorIVC))
+                        dtype = vdm.vectorNumpyDtype(vectorIVC)
+                        res = vdm.extractVectorContentsAsBase64(vectorIVC, 0, len(vectorIVC))
 
-                        if res is not None:
-                            assert len(res) == len(vectorIVC)
+                        if dtype is not None and res is not None:
                             firstElement = vdm.extractVectorItem(vectorIVC, 0)
-                            return {'firstElement': firstElement, 'contentsAsNumpyArrays': [res]}
+                            return {
+                                'firstElement': firstElement,
+                                'dtype': dtype,
+                                'contentsAsBase64Chunks': [(res, len(vectorIVC))]
+                                }
 
                     #see if we can extract the data as a regular pythonlist
                     res = vdm.extractVectorContentsAsPythonArray(vectorIVC, 0, len(vectorIVC)) 
@@ -268,9 +272,10 @@ class PyforaResultAsJson(ComputedGraph.Location):
                     if res is not None:
                         res = {'string': res.tostring()}
 
-                #see if it's simple enough to transmit as numpy data
+                #see if it's simple enough to transmit as raw numpy data
                 if res is None and len(vectorIVC.getVectorElementsJOR()) == 1 and len(vectorIVC) > 1:
-                    res = vecSlice.extractVectorDataAsNumpyArrayInChunks()
+                    dtype = vecSlice.vectorNumpyDtype()
+                    res = vecSlice.extractVectorDataAsBase64InChunks() if dtype is not None else None
 
                     if res is not None:
                         firstElement = vecSlice.extractVectorItemAsIVC(0)
@@ -282,7 +287,11 @@ class PyforaResultAsJson(ComputedGraph.Location):
                                 "Shouldn't be possible to download data as numpy, and then not get the first value"
                                 )
 
-                        res = {'firstElement': firstElement, 'contentsAsNumpyArrays': res}
+                        res = {
+                            'firstElement': firstElement,
+                            'dtype': dtype,
+                            'contentsAsBase64Chunks': res
+                            }
                     else:
                         if not vecSlice.vdmThinksIsLoaded():
                             #there's a race condition where the data could be loaded between now and
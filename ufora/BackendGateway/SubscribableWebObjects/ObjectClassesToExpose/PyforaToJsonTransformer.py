@@ -57,7 +57,7 @@ class PyforaToJsonTransformer(object):
         numpyAsStrings = [{'data':base64.b64encode(x.tostring()).encode("utf8"), 'length':len(x)} for x in allElementsAsNumpyArrays]
         numpyDtypeAsString = base64.b64encode(cPickle.dumps(allElementsAsNumpyArrays[0].dtype))
 
-        self.accumulateObjects(1, sum(len(x) for x in numpyAsStrings) + len(numpyDtypeAsString))
+        self.accumulateObjects(1, sum(len(x['data']) for x in numpyAsStrings) + len(numpyDtypeAsString))
 
         return {
             'homogenousListNumpyDataStringsAndSizes': numpyAsStrings,
@@ -66,6 +66,23 @@ class PyforaToJsonTransformer(object):
             'length': sum(len(x) for x in allElementsAsNumpyArrays)
             }
 
+    def transformHomogenousListFromBase64Chunks(self, firstElement, dtype, base64ChunksAndSizes):
+        """Like transformHomogenousList, but for data the VDM has already base64 encoded.
+
+        base64ChunksAndSizes - a list of (base64String, elementCount) pairs
+        """
+        numpyAsStrings = [{'data': data, 'length': length} for data, length in base64ChunksAndSizes]
+        numpyDtypeAsString = base64.b64encode(cPickle.dumps(dtype))
+
+        self.accumulateObjects(1, sum(len(x['data']) for x in numpyAsStrings) + len(numpyDtypeAsString))
+
+        return {
+            'homogenousListNumpyDataStringsAndSizes': numpyAsStrings,
+            'dtype': numpyDtypeAsString,
+            'firstElement': firstElement,
+            'length': sum(length for _, length in base64ChunksAndSizes)
+            }
+
     def transformDict(self, keys, values):
         self.accumulateObjects(1)
         return {
@@ -0,0 +1,46 @@
+#   Copyright 2015 Ufora Inc.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import unittest
+import base64
+import numpy
+import ufora.BackendGateway.SubscribableWebObjects.ObjectClassesToExpose.PyforaToJsonTransformer \
+    as PyforaToJsonTransformer
+
+
+class PyforaToJsonTransformerTest(unittest.TestCase):
+    def test_homogenous_lists_count_their_encoded_data(self):
+        data = numpy.arange(1000, dtype='float64')
+        encoded = base64.b64encode(data.tostring())
+
+        fromChunks = PyforaToJsonTransformer.PyforaToJsonTransformer()
+        fromChunks.transformHomogenousListFromBase64Chunks(0.0, data.dtype, [(encoded, 1000)])
+
+        fromArrays = PyforaToJsonTransformer.PyforaToJsonTransformer()
+        fromArrays.transformHomogenousList(0.0, [data])
+
+        self.assertGreater(fromChunks.bytesEncoded, len(encoded))
+        self.assertEqual(fromChunks.bytesEncoded, fromArrays.bytesEncoded)
+
+    def test_homogenous_lists_respect_max_bytecount(self):
+        data = numpy.arange(1000, dtype='float64')
+        encoded = base64.b64encode(data.tostring())
+
+        transformer = PyforaToJsonTransformer.PyforaToJsonTransformer(maxBytecount=len(encoded) / 2)
+
+        with self.assertRaises(PyforaToJsonTransformer.HaltTransformationException):
+            transformer.transformHomogenousListFromBase64Chunks(0.0, data.dtype, [(encoded, 1000)])
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,155 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include "../Core/ExecutionContext.hppml"
+#include "../TypedFora/ABI/ForaValueArray.hppml"
+#include "../TypedFora/ABI/ForaValueArraySlice.hppml"
+#include "../TypedFora/ABI/VectorRecord.hpp"
+#include "../../core/AtomicOps.hpp"
+#include <vector>
+
+/***************
+PodColumns
+
+Helpers for axioms that copy homogenous vectors of POD values (Int64, Float64, or tuples of
+them) out into plain arrays, run a kernel over them, and build a new vector from the result.
+***************/
+
+namespace Fora {
+namespace PodColumns {
+
+//copy the values at [low, high) of a vector of 'T' into 'outValues'. Returns false if some of
+//the range isn't loaded.
+template<class T>
+bool copyRange(
+			const TypedFora::Abi::VectorRecord& vec,
+			int64_t low,
+			int64_t high,
+			std::vector<T>& outValues
+			)
+	{
+	outValues.resize(high - low);
+
+	int64_t index = low;
+
+	while (index < high)
+		{
+		TypedFora::Abi::ForaValueArraySlice slice = vec.sliceForOffset(index);
+
+		if (!slice.array() || !slice.mapping().indexIsValid(index))
+			return false;
+
+		int64_t top = std::min<int64_t>(high, slice.mapping().highIndex());
+
+		for (int64_t k = index; k < top; k++)
+			outValues[k - low] = *(T*)slice.offsetFor(k);
+
+		index = top;
+		}
+
+	return true;
+	}
+
+template<class T>
+bool copyColumn(const TypedFora::Abi::VectorRecord& vec, std::vector<T>& outValues)
+	{
+	return copyRange(vec, 0, vec.size(), outValues);
+	}
+
+template<class T>
+Type typeFor();
+
+template<>
+inline Type typeFor<int64_t>()
+	{
+	return Type::Integer(64, true);
+	}
+
+template<>
+inline Type typeFor<double>()
+	{
+	return Type::Float(64);
+	}
+
+inline Type pairType(const Type& first, const Type& second)
+	{
+	return Type::UnnamedTuple(emptyTreeVec() + first + second);
+	}
+
+//how many upcoming createVector calls should be refused as if the pool had denied them. Lets
+//tests check that callers fall back correctly. See `DenyColumnAllocationsForTesting.
+inline AO_t* allocationsToDenyForTesting()
+	{
+	static AO_t count = 0;
+
+	return &count;
+	}
+
+inline void denyAllocationsForTesting(int64_t count)
+	{
+	AO_store(allocationsToDenyForTesting(), count);
+	}
+
+inline bool shouldDenyAllocationForTesting()
+	{
+	AO_t* count = allocationsToDenyForTesting();
+
+	while (true)
+		{
+		AO_t current = AO_load(count);
+
+		if (current <= 0)
+			return false;
+
+		if (AO_compare_and_swap_full(count, current, current - 1))
+			return true;
+		}
+	}
+
+//build a vector of 'count' values of 'type', packed one after the other at 'data', in the
+//current ExecutionContext's pool. Returns false if the pool won't permit the allocation, in
+//which case the caller has no result and must say so rather than return a shorter vector.
+inline bool createVector(
+			const Type& type,
+			uint8_t* data,
+			int64_t count,
+			TypedFora::Abi::VectorRecord& outVector
+			)
+	{
+	if (!count)
+		{
+		outVector = TypedFora::Abi::VectorRecord();
+		return true;
+		}
+
+	MemoryPool* pool = Fora::Interpreter::ExecutionContext::currentExecutionContext()->getMemoryPool();
+
+	if (shouldDenyAllocationForTesting() || !pool->permitAllocation(count * type.size()))
+		return false;
+
+	TypedFora::Abi::ForaValueArray* array = TypedFora::Abi::ForaValueArray::Empty(pool);
+
+	array->append(JOV::OfType(type), data, count, type.size());
+
+	outVector = TypedFora::Abi::VectorRecord::createWithinExecutionContext(array);
+
+	return true;
+	}
+
+}
+}
+
@@ -117,6 +117,10 @@ public:
 
 	virtual bool permitAllocation(size_t inBytes) = 0;
 
+	//called when a large batch of objects has just been released (e.g. when a RefcountPool
+	//is cleared). Pools that cache freed memory may give it back at this point.
+	virtual void releaseCachedAllocations() {};
+
 	virtual void vectorPageMapped(
 						boost::shared_ptr<VectorPage> mappedPage,
 						boost::shared_ptr<Ufora::threading::Trigger> mappedPageWantsUnmapped
@@ -0,0 +1,349 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "SlabAllocator.hpp"
+
+#include "../../core/lassert.hpp"
+#include <new>
+
+//the header that lives at the base of every slab. Objects are carved out of the space
+//that follows it.
+class SlabAllocator::Slab {
+public:
+	uint8_t* mBumpPtr;
+
+	uint8_t* mEnd;
+
+	void* mFreeList;
+
+	size_t mLiveCount;
+
+	size_t mSizeClass;
+
+	SlabState mState;
+
+	Slab* mPrev;
+
+	Slab* mNext;
+
+	//bytes at the front of the slab reserved for the header, rounded so that objects stay aligned
+	static size_t headerBytes()
+		{
+		return (sizeof(Slab) + kSizeClassGranularity - 1) /
+			kSizeClassGranularity * kSizeClassGranularity;
+		}
+
+	uint8_t* base()
+		{
+		return (uint8_t*)this;
+		}
+
+	bool contains(void* inPtr)
+		{
+		return (uint8_t*)inPtr >= base() && (uint8_t*)inPtr < base() + kSlabBytes;
+		}
+
+	bool hasSpace()
+		{
+		return mFreeList || mBumpPtr + bytesForSizeClass(mSizeClass) <= mEnd;
+		}
+};
+
+void SlabAllocator::SlabList::push(Slab* inSlab)
+	{
+	inSlab->mPrev = 0;
+	inSlab->mNext = mHead;
+
+	if (mHead)
+		mHead->mPrev = inSlab;
+
+	mHead = inSlab;
+	}
+
+void SlabAllocator::SlabList::remove(Slab* inSlab)
+	{
+	if (inSlab->mPrev)
+		inSlab->mPrev->mNext = inSlab->mNext;
+	else
+		mHead = inSlab->mNext;
+
+	if (inSlab->mNext)
+		inSlab->mNext->mPrev = inSlab->mPrev;
+
+	inSlab->mPrev = 0;
+	inSlab->mNext = 0;
+	}
+
+SlabAllocator::Slab* SlabAllocator::SlabList::pop()
+	{
+	Slab* result = mHead;
+
+	if (result)
+		remove(result);
+
+	return result;
+	}
+
+SlabAllocator::SlabAllocator(
+			boost::function1<void*, size_t> inAllocateSlab,
+			boost::function1<void, void*> inFreeSlab
+			) :
+		mAllocateSlab(inAllocateSlab),
+		mFreeSlab(inFreeSlab),
+		mSlabCount(0),
+		mBytesAllocated(0)
+	{
+	for (long k = 0; k < kSizeClassCount; k++)
+		mCurrentSlabs[k] = 0;
+	}
+
+SlabAllocator::~SlabAllocator()
+	{
+	std::vector<Slab*> slabs;
+
+	for (auto& regionAndSlabs: mSlabsByRegion)
+		{
+		//each slab is keyed under the region containing its base address, and possibly
+		//under the following one as well. Only collect it from the first.
+		for (Slab* slab: {regionAndSlabs.second.first, regionAndSlabs.second.second})
+			if (slab && (uintptr_t)slab->base() / kSlabBytes == regionAndSlabs.first)
+				slabs.push_back(slab);
+		}
+
+	for (Slab* slab: slabs)
+		releaseSlab(slab);
+	}
+
+void* SlabAllocator::allocate(size_t inBytes)
+	{
+	lassert(isSmall(inBytes));
+
+	size_t sizeClass = sizeClassFor(inBytes);
+
+	Slab* slab = mCurrentSlabs[sizeClass];
+
+	if (!slab || !slab->hasSpace())
+		{
+		if (slab)
+			slab->mState = SlabState::Full;
+
+		slab = acquireSlab(sizeClass);
+
+		mCurrentSlabs[sizeClass] = slab;
+
+		if (!slab)
+			return 0;
+
+		slab->mState = SlabState::Current;
+		}
+
+	void* result;
+
+	if (slab->mFreeList)
+		{
+		result = slab->mFreeList;
+		slab->mFreeList = *(void**)result;
+		}
+	else
+		{
+		result = slab->mBumpPtr;
+		slab->mBumpPtr += bytesForSizeClass(sizeClass);
+		}
+
+	slab->mLiveCount++;
+	mBytesAllocated += bytesForSizeClass(sizeClass);
+
+	return result;
+	}
+
+bool SlabAllocator::free(void* inPtr)
+	{
+	Slab* slab = slabFor(inPtr);
+
+	if (!slab)
+		return false;
+
+	lassert(slab->mLiveCount > 0);
+
+	*(void**)inPtr = slab->mFreeList;
+	slab->mFreeList = inPtr;
+
+	slab->mLiveCount--;
+	mBytesAllocated -= bytesForSizeClass(slab->mSizeClass);
+
+	if (slab->mState == SlabState::Full)
+		{
+		if (slab->mLiveCount == 0)
+			{
+			slab->mState = SlabState::Empty;
+			mEmptySlabs.push(slab);
+			}
+		else
+			{
+			slab->mState = SlabState::Partial;
+			mPartialSlabs[slab->mSizeClass].push(slab);
+			}
+		}
+		else
+	if (slab->mState == SlabState::Partial && slab->mLiveCount == 0)
+		{
+		mPartialSlabs[slab->mSizeClass].remove(slab);
+		slab->mState = SlabState::Empty;
+		mEmptySlabs.push(slab);
+		}
+
+	return true;
+	}
+
+size_t SlabAllocator::allocationSize(void* inPtr) const
+	{
+	Slab* slab = slabFor(inPtr);
+
+	if (!slab)
+		return 0;
+
+	return bytesForSizeClass(slab->mSizeClass);
+	}
+
+void SlabAllocator::releaseEmptySlabs()
+	{
+	while (Slab* slab = mEmptySlabs.pop())
+		releaseSlab(slab);
+
+	for (long k = 0; k < kSizeClassCount; k++)
+		if (mCurrentSlabs[k] && mCurrentSlabs[k]->mLiveCount == 0)
+			{
+			releaseSlab(mCurrentSlabs[k]);
+			mCurrentSlabs[k] = 0;
+			}
+	}
+
+SlabAllocator::Slab* SlabAllocator::slabFor(void* inPtr) const
+	{
+	auto it = mSlabsByRegion.find((uintptr_t)inPtr / kSlabBytes);
+
+	if (it == mSlabsByRegion.end())
+		return 0;
+
+	if (it->second.first->contains(inPtr))
+		return it->second.first;
+
+	if (it->second.second && it->second.second->contains(inPtr))
+		return it->second.second;
+
+	return 0;
+	}
+
+SlabAllocator::Slab* SlabAllocator::acquireSlab(size_t inSizeClass)
+	{
+	Slab* slab = mPartialSlabs[inSizeClass].pop();
+
+	if (slab)
+		return slab;
+
+	slab = mEmptySlabs.pop();
+
+	if (slab)
+		{
+		initializeSlab(slab, inSizeClass);
+		return slab;
+		}
+
+	void* data = mAllocateSlab(kSlabBytes);
+
+	if (!data)
+		return 0;
+
+	lassert((uintptr_t)data % kSizeClassGranularity == 0);
+
+	slab = new (data) Slab();
+
+	initializeSlab(slab, inSizeClass);
+
+	registerSlab(slab);
+
+	mSlabCount++;
+
+	return slab;
+	}
+
+void SlabAllocator::initializeSlab(Slab* slab, size_t inSizeClass)
+	{
+	slab->mBumpPtr = slab->base() + Slab::headerBytes();
+	slab->mEnd = slab->base() + kSlabBytes;
+	slab->mFreeList = 0;
+	slab->mLiveCount = 0;
+	slab->mSizeClass = inSizeClass;
+	slab->mPrev = 0;
+	slab->mNext = 0;
+	}
+
+void SlabAllocator::releaseSlab(Slab* slab)
+	{
+	unregisterSlab(slab);
+
+	mSlabCount--;
+
+	slab->~Slab();
+
+	mFreeSlab(slab);
+	}
+
+void SlabAllocator::registerSlab(Slab* slab)
+	{
+	uintptr_t firstRegion = (uintptr_t)slab->base() / kSlabBytes;
+	uintptr_t lastRegion = ((uintptr_t)slab->base() + kSlabBytes - 1) / kSlabBytes;
+
+	for (uintptr_t region = firstRegion; region <= lastRegion; region++)
+		{
+		std::pair<Slab*, Slab*>& slabs = mSlabsByRegion[region];
+
+		if (!slabs.first)
+			slabs.first = slab;
+		else
+			{
+			lassert(!slabs.second);
+			slabs.second = slab;
+			}
+		}
+	}
+
+void SlabAllocator::unregisterSlab(Slab* slab)
+	{
+	uintptr_t firstRegion = (uintptr_t)slab->base() / kSlabBytes;
+	uintptr_t lastRegion = ((uintptr_t)slab->base() + kSlabBytes - 1) / kSlabBytes;
+
+	for (uintptr_t region = firstRegion; region <= lastRegion; region++)
+		{
+		auto it = mSlabsByRegion.find(region);
+
+		lassert(it != mSlabsByRegion.end());
+
+		if (it->second.first == slab)
+			{
+			it->second.first = it->second.second;
+			it->second.second = 0;
+			}
+		else
+			{
+			lassert(it->second.second == slab);
+			it->second.second = 0;
+			}
+
+		if (!it->second.first)
+			mSlabsByRegion.erase(it);
+		}
+	}
+
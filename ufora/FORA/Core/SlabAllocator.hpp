@@ -0,0 +1,171 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <boost/function.hpp>
+#include <boost/unordered_map.hpp>
+#include <stdint.h>
+#include <vector>
+
+/**************
+
+SlabAllocator
+
+A size-class front end for small allocations. Requests of up to kMaxSmallAllocation bytes are
+rounded up to a multiple of kSizeClassGranularity and carved out of fixed-size slabs that we
+obtain from a backing allocator. Each slab serves a single size class and keeps its own
+intrusive free list, so allocating or freeing a small object touches a single slab header.
+Fresh slabs are bump-allocated, which means a burst of short-lived temporaries never touches
+a free list at all.
+
+Slabs whose objects have all been freed are kept around for reuse (by any size class) until
+'releaseEmptySlabs' hands them back to the backing allocator.
+
+Not threadsafe: each instance is owned by a single memory pool.
+
+***************/
+
+class SlabAllocator {
+	SlabAllocator(const SlabAllocator&); //not implemented
+	SlabAllocator& operator=(const SlabAllocator& in); //not implemented
+public:
+	const static size_t kSizeClassGranularity = 16;
+
+	const static size_t kMaxSmallAllocation = 256;
+
+	const static size_t kSizeClassCount = kMaxSmallAllocation / kSizeClassGranularity;
+
+	const static size_t kSlabBytes = 16 * 1024;
+
+	SlabAllocator(
+			boost::function1<void*, size_t> inAllocateSlab,
+			boost::function1<void, void*> inFreeSlab
+			);
+
+	//releases every slab, whether or not it's empty.
+	~SlabAllocator();
+
+	//should an allocation of this size be routed through the slabs?
+	static bool isSmall(size_t inBytes)
+		{
+		return inBytes <= kMaxSmallAllocation;
+		}
+
+	static size_t sizeClassFor(size_t inBytes)
+		{
+		return inBytes ? (inBytes - 1) / kSizeClassGranularity : 0;
+		}
+
+	static size_t bytesForSizeClass(size_t inSizeClass)
+		{
+		return (inSizeClass + 1) * kSizeClassGranularity;
+		}
+
+	//allocate 'inBytes', which must satisfy 'isSmall'. Returns null if the backing allocator
+	//couldn't provide a new slab.
+	void* allocate(size_t inBytes);
+
+	//release a pointer. Returns false (and does nothing) if the pointer wasn't allocated
+	//by this allocator.
+	bool free(void* inPtr);
+
+	//the usable size of a pointer allocated by this allocator, or zero if we don't own it.
+	size_t allocationSize(void* inPtr) const;
+
+	//hand every slab with no live allocations back to the backing allocator.
+	void releaseEmptySlabs();
+
+	//total bytes of slab we're holding from the backing allocator
+	size_t getBytesReserved() const
+		{
+		return mSlabCount * kSlabBytes;
+		}
+
+	//total bytes handed out to clients and not yet freed
+	size_t getBytesAllocated() const
+		{
+		return mBytesAllocated;
+		}
+
+	size_t getSlabCount() const
+		{
+		return mSlabCount;
+		}
+
+private:
+	class Slab;
+
+	//a slab is either the current slab for its class, on the partial list for its class,
+	//full (and on no list), or on the empty list.
+	enum class SlabState {
+		Current,
+		Partial,
+		Full,
+		Empty
+	};
+
+	class SlabList {
+	public:
+		SlabList() : mHead(0)
+			{
+			}
+
+		void push(Slab* inSlab);
+
+		void remove(Slab* inSlab);
+
+		Slab* pop();
+
+		Slab* head() const
+			{
+			return mHead;
+			}
+
+	private:
+		Slab* mHead;
+	};
+
+	Slab* slabFor(void* inPtr) const;
+
+	Slab* acquireSlab(size_t inSizeClass);
+
+	void initializeSlab(Slab* slab, size_t inSizeClass);
+
+	void releaseSlab(Slab* slab);
+
+	void registerSlab(Slab* slab);
+
+	void unregisterSlab(Slab* slab);
+
+	boost::function1<void*, size_t> mAllocateSlab;
+
+	boost::function1<void, void*> mFreeSlab;
+
+	Slab* mCurrentSlabs[kSizeClassCount];
+
+	SlabList mPartialSlabs[kSizeClassCount];
+
+	SlabList mEmptySlabs;
+
+	//slabs aren't aligned to kSlabBytes, so each kSlabBytes-wide region of the address space
+	//can overlap at most two of them. We key each slab under both of the regions it touches.
+	boost::unordered_map<uintptr_t, std::pair<Slab*, Slab*> > mSlabsByRegion;
+
+	size_t mSlabCount;
+
+	size_t mBytesAllocated;
+};
+
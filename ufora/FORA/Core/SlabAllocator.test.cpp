@@ -0,0 +1,178 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "SlabAllocator.hpp"
+#include "../../core/UnitTest.hpp"
+#include <boost/bind.hpp>
+#include <boost/random.hpp>
+#include <map>
+
+namespace {
+
+void* mallocSlab(long* outstanding, size_t inBytes)
+	{
+	(*outstanding)++;
+	return ::malloc(inBytes);
+	}
+
+void freeSlab(long* outstanding, void* inSlab)
+	{
+	(*outstanding)--;
+	::free(inSlab);
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_SlabAllocator )
+
+BOOST_AUTO_TEST_CASE( test_size_classes )
+	{
+	BOOST_CHECK_EQUAL(SlabAllocator::sizeClassFor(0), 0);
+	BOOST_CHECK_EQUAL(SlabAllocator::sizeClassFor(1), 0);
+	BOOST_CHECK_EQUAL(SlabAllocator::sizeClassFor(16), 0);
+	BOOST_CHECK_EQUAL(SlabAllocator::sizeClassFor(17), 1);
+	BOOST_CHECK_EQUAL(SlabAllocator::sizeClassFor(256), SlabAllocator::kSizeClassCount - 1);
+
+	for (long k = 0; k <= SlabAllocator::kMaxSmallAllocation; k++)
+		BOOST_CHECK(SlabAllocator::bytesForSizeClass(SlabAllocator::sizeClassFor(k)) >= k);
+
+	BOOST_CHECK(!SlabAllocator::isSmall(SlabAllocator::kMaxSmallAllocation + 1));
+	}
+
+BOOST_AUTO_TEST_CASE( test_allocate_and_free )
+	{
+	long outstanding = 0;
+
+	SlabAllocator allocator(
+		boost::bind(&mallocSlab, &outstanding, _1),
+		boost::bind(&freeSlab, &outstanding, _1)
+		);
+
+	void* p1 = allocator.allocate(10);
+	void* p2 = allocator.allocate(10);
+	void* p3 = allocator.allocate(100);
+
+	BOOST_CHECK(p1 != p2);
+	BOOST_CHECK_EQUAL(allocator.allocationSize(p1), 16);
+	BOOST_CHECK_EQUAL(allocator.allocationSize(p3), 112);
+	BOOST_CHECK_EQUAL(allocator.getBytesAllocated(), 16 + 16 + 112);
+	BOOST_CHECK_EQUAL(allocator.getSlabCount(), 2);
+	BOOST_CHECK_EQUAL(outstanding, 2);
+
+	//pointers we don't own are rejected
+	int onTheStack;
+	BOOST_CHECK(!allocator.free(&onTheStack));
+	BOOST_CHECK_EQUAL(allocator.allocationSize(&onTheStack), 0);
+
+	BOOST_CHECK(allocator.free(p1));
+
+	//freed slots are reused
+	BOOST_CHECK(allocator.allocate(16) == p1);
+
+	allocator.free(p1);
+	allocator.free(p2);
+	allocator.free(p3);
+
+	BOOST_CHECK_EQUAL(allocator.getBytesAllocated(), 0);
+
+	allocator.releaseEmptySlabs();
+
+	BOOST_CHECK_EQUAL(allocator.getSlabCount(), 0);
+	BOOST_CHECK_EQUAL(outstanding, 0);
+	}
+
+BOOST_AUTO_TEST_CASE( test_empty_slabs_are_reused_across_size_classes )
+	{
+	long outstanding = 0;
+
+	SlabAllocator allocator(
+		boost::bind(&mallocSlab, &outstanding, _1),
+		boost::bind(&freeSlab, &outstanding, _1)
+		);
+
+	std::vector<void*> pointers;
+
+	for (long k = 0; k < 10000; k++)
+		pointers.push_back(allocator.allocate(16));
+
+	long slabCount = allocator.getSlabCount();
+
+	for (auto p: pointers)
+		allocator.free(p);
+
+	pointers.clear();
+
+	for (long k = 0; k < 4000; k++)
+		pointers.push_back(allocator.allocate(32));
+
+	BOOST_CHECK_EQUAL(allocator.getSlabCount(), slabCount);
+
+	for (auto p: pointers)
+		allocator.free(p);
+	}
+
+BOOST_AUTO_TEST_CASE( test_randomized )
+	{
+	long outstanding = 0;
+
+	{
+		SlabAllocator allocator(
+			boost::bind(&mallocSlab, &outstanding, _1),
+			boost::bind(&freeSlab, &outstanding, _1)
+			);
+
+		boost::mt19937 generator(1);
+
+		std::map<uint8_t*, std::pair<size_t, uint8_t> > live;
+
+		for (long pass = 0; pass < 200000; pass++)
+			{
+			if (live.size() < 2000 && (live.empty() || generator() % 2))
+				{
+				size_t bytes = generator() % (SlabAllocator::kMaxSmallAllocation + 1);
+				uint8_t fill = generator();
+
+				uint8_t* p = (uint8_t*)allocator.allocate(bytes);
+
+				BOOST_REQUIRE(allocator.allocationSize(p) >= bytes);
+				BOOST_REQUIRE(live.find(p) == live.end());
+
+				memset(p, fill, bytes);
+				live[p] = std::make_pair(bytes, fill);
+				}
+			else
+				{
+				auto it = live.lower_bound((uint8_t*)(uintptr_t)generator());
+				if (it == live.end())
+					it = live.begin();
+
+				for (long k = 0; k < it->second.first; k++)
+					BOOST_REQUIRE(it->first[k] == it->second.second);
+
+				BOOST_REQUIRE(allocator.free(it->first));
+				live.erase(it);
+				}
+
+			if (pass % 10000 == 0)
+				allocator.releaseEmptySlabs();
+			}
+	}
+
+	//destroying the allocator hands back every slab
+	BOOST_CHECK_EQUAL(outstanding, 0);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
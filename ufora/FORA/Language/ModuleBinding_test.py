@@ -206,6 +206,35 @@ class ModuleBindingTest(unittest.TestCase):
         self.assertTrue(m1.getObjectMember('f') != m2.getObjectMember('f'))
         self.assertTrue(m1.getObjectMember('z') != m2.getObjectMember('z'))
 
+    def test_rebinding_with_shared_parser_reuses_unchanged_members(self):
+        parser = ForaNative.ModuleParser()
+
+        def tree(zBody):
+            return ("builtin", """
+                f: fun(0) { 'f' } (x){ g(x-1) };
+                g: fun(0) { 'g' } (x){ f(x-1) };
+                z: fun(x) { %s }
+                """ % zBody, [])
+
+        def parseAndBind(zBody):
+            result = parser.parse(
+                sourceCodeTree(tree(zBody)),
+                True,
+                ForaNative.CodeDefinitionPoint.ExternalFromStringList([])
+                )
+
+            return parser.bind(result, {}, True).asModule.result
+
+        m1 = parseAndBind("x")
+        m2 = parseAndBind("x+1")
+        m3 = parseAndBind("x")
+
+        self.assertTrue(m1.getObjectMember('f') == m2.getObjectMember('f'))
+        self.assertTrue(m1.getObjectMember('z') != m2.getObjectMember('z'))
+        self.assertTrue(m1 == m3)
+
+        self.assertTrue(self.parseAndBind(tree("x+1")).asModule.result == m2)
+
     def test_parse_errors_dont_prevent_all_entries(self):
         m1 = self.parseAndBind(
             ("builtin", """
@@ -0,0 +1,122 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include "../../core/math/Hash.hpp"
+#include "../../core/math/Nullable.hpp"
+#include <boost/thread.hpp>
+#include <map>
+
+namespace Fora {
+
+/************************
+
+ModuleParserCache
+
+A thread-safe map from content hashes to parse or binding results, used by
+ModuleParser to avoid re-parsing and re-binding parts of a module tree that
+haven't changed.
+
+Entries live in two generations. Lookups hit in either, and hits in the old
+generation are promoted. When the current generation fills up, it becomes the
+old one and the previous old generation is dropped, so anything not touched
+for a full generation is forgotten.
+
+************************/
+
+template<class T>
+class ModuleParserCache {
+public:
+	ModuleParserCache(long inMaxEntriesPerGeneration = 100000) :
+			mMaxEntriesPerGeneration(inMaxEntriesPerGeneration),
+			mHits(0),
+			mMisses(0)
+		{
+		}
+
+	Nullable<T> get(const hash_type& key)
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		auto it = mCurrent.find(key);
+
+		if (it != mCurrent.end())
+			{
+			mHits++;
+			return null() << it->second;
+			}
+
+		it = mPrevious.find(key);
+
+		if (it != mPrevious.end())
+			{
+			mHits++;
+			T value = it->second;
+			insert_(key, value);
+			return null() << value;
+			}
+
+		mMisses++;
+		return null();
+		}
+
+	void set(const hash_type& key, const T& value)
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		insert_(key, value);
+		}
+
+	long hits() const
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		return mHits;
+		}
+
+	long misses() const
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		return mMisses;
+		}
+
+private:
+	void insert_(const hash_type& key, const T& value)
+		{
+		if (mCurrent.size() >= mMaxEntriesPerGeneration)
+			{
+			mPrevious.clear();
+			std::swap(mPrevious, mCurrent);
+			}
+
+		mCurrent[key] = value;
+		}
+
+	mutable boost::mutex mMutex;
+
+	long mMaxEntriesPerGeneration;
+
+	std::map<hash_type, T> mCurrent;
+
+	std::map<hash_type, T> mPrevious;
+
+	long mHits;
+
+	long mMisses;
+};
+
+}
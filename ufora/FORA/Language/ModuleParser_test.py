@@ -146,3 +146,37 @@ class ModuleParserTest(unittest.TestCase):
         self.assertTrue(memberForResult.isMember())
         self.assertEqual(memberForResult.asMember.name, symbols[0])
 
+
+    def test_reparse_with_shared_parser_matches_fresh_parse(self):
+        def tree(zBody):
+            return sourceCodeTree(
+                ("builtin", "f: 10;", [
+                    ("math", "a: 10; b: fun(x) { x + a };", [
+                        ("linalg", "c: math.b(1);")
+                        ]),
+                    ("regression", "z: fun(x) { %s };" % zBody),
+                    ("test.script", "let x = math.a; x + 1")
+                    ])
+                )
+
+        parser = ForaNative.ModuleParser()
+        cdp = ForaNative.CodeDefinitionPoint.ExternalFromStringList([])
+
+        for zBody in ["x", "x + 1", "x", "(x"]:
+            cachedResult = parser.parse(tree(zBody), True, cdp)
+            freshResult = self.parse(tree(zBody))
+
+            self.assertEqual(cachedResult.hash, freshResult.hash)
+            self.assertEqual(len(cachedResult.errors), len(freshResult.errors))
+
+    def test_parse_wide_tree(self):
+        result = self.parse(
+            ("builtin", "", [
+                ("m%s" % ix, "a: %s; b: fun(x) { x + a };" % ix) for ix in range(100)
+                ] + [
+                ("s%s.script" % ix, "let x = %s; x + 1" % ix) for ix in range(100)
+                ])
+            )
+
+        self.assertEqual(len(result.errors), 0)
+        self.assertEqual(len(result.getMembers()), 300)
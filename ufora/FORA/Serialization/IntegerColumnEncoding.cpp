@@ -0,0 +1,378 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "IntegerColumnEncoding.hpp"
+#include "../../core/lassert.hpp"
+#include <algorithm>
+#include <string.h>
+
+namespace Fora {
+
+namespace {
+
+uint64_t lowBitMask(uword_t bits)
+	{
+	return bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+	}
+
+//values are stored little-endian, as on every platform we target
+uint64_t readValue(const uint8_t* data, uword_t byteWidth, bool isSigned)
+	{
+	uint64_t value = 0;
+	memcpy(&value, data, byteWidth);
+
+	if (isSigned && byteWidth < 8 && (value >> (byteWidth * 8 - 1)) & 1)
+		value |= ~uint64_t(0) << (byteWidth * 8);
+
+	return value;
+	}
+
+void writeValue(uint8_t* data, uword_t byteWidth, uint64_t value)
+	{
+	memcpy(data, &value, byteWidth);
+	}
+
+void appendValue(std::vector<uint8_t>& out, uint64_t value)
+	{
+	uint8_t bytes[sizeof(uint64_t)];
+	memcpy(bytes, &value, sizeof(uint64_t));
+	out.insert(out.end(), bytes, bytes + sizeof(uint64_t));
+	}
+
+class BitWriter {
+public:
+	BitWriter(std::vector<uint8_t>& out) :
+			mOut(out),
+			mBits(0),
+			mBitCount(0)
+		{
+		}
+
+	void write(uint64_t value, uword_t bits)
+		{
+		while (bits > 0)
+			{
+			uword_t take = std::min<uword_t>(bits, 64 - mBitCount);
+
+			mBits |= (value & lowBitMask(take)) << mBitCount;
+			mBitCount += take;
+
+			value = take >= 64 ? 0 : value >> take;
+			bits -= take;
+
+			if (mBitCount == 64)
+				{
+				appendValue(mOut, mBits);
+				mBits = 0;
+				mBitCount = 0;
+				}
+			}
+		}
+
+	void finish()
+		{
+		for (uword_t k = 0; k * 8 < mBitCount; k++)
+			mOut.push_back((mBits >> (k * 8)) & 0xFF);
+
+		mBits = 0;
+		mBitCount = 0;
+		}
+
+private:
+	std::vector<uint8_t>& mOut;
+
+	uint64_t mBits;
+
+	uword_t mBitCount;
+};
+
+class BitReader {
+public:
+	BitReader(const uint8_t* data, const uint8_t* end) :
+			mData(data),
+			mEnd(end),
+			mBits(0),
+			mBitCount(0)
+		{
+		}
+
+	uint64_t read(uword_t bits)
+		{
+		uint64_t result = 0;
+		uword_t produced = 0;
+
+		while (produced < bits)
+			{
+			if (mBitCount == 0)
+				refill();
+
+			uword_t take = std::min<uword_t>(bits - produced, mBitCount);
+
+			result |= (mBits & lowBitMask(take)) << produced;
+
+			mBits = take >= 64 ? 0 : mBits >> take;
+			mBitCount -= take;
+			produced += take;
+			}
+
+		return result;
+		}
+
+private:
+	void refill()
+		{
+		uword_t bytes = std::min<uword_t>(sizeof(uint64_t), mEnd - mData);
+
+		lassert_dump(bytes > 0, "ran off the end of a bit-packed integer column");
+
+		mBits = 0;
+		memcpy(&mBits, mData, bytes);
+
+		mData += bytes;
+		mBitCount = bytes * 8;
+		}
+
+	const uint8_t* mData;
+
+	const uint8_t* mEnd;
+
+	uint64_t mBits;
+
+	uword_t mBitCount;
+};
+
+//the smallest and largest of a set of values, compared as signed or unsigned integers
+class ValueRange {
+public:
+	ValueRange(bool isSigned) :
+			mIsSigned(isSigned),
+			mIsEmpty(true),
+			mMin(0),
+			mMax(0)
+		{
+		}
+
+	void observe(uint64_t value)
+		{
+		if (mIsEmpty)
+			{
+			mMin = mMax = value;
+			mIsEmpty = false;
+			return;
+			}
+
+		if (lessThan(value, mMin))
+			mMin = value;
+		if (lessThan(mMax, value))
+			mMax = value;
+		}
+
+	uint64_t min() const
+		{
+		return mMin;
+		}
+
+	uword_t bitsToRepresentOffsets() const
+		{
+		return IntegerColumnEncoding::bitsToRepresent(mMax - mMin);
+		}
+
+private:
+	bool lessThan(uint64_t lhs, uint64_t rhs) const
+		{
+		return mIsSigned ? int64_t(lhs) < int64_t(rhs) : lhs < rhs;
+		}
+
+	bool mIsSigned;
+
+	bool mIsEmpty;
+
+	uint64_t mMin;
+
+	uint64_t mMax;
+};
+
+uword_t bytesForBits(uword_t bits)
+	{
+	return (bits + 7) / 8;
+	}
+
+}
+
+uword_t IntegerColumnEncoding::bitsToRepresent(uint64_t range)
+	{
+	uword_t bits = 0;
+
+	while (bits < 64 && (range >> bits))
+		bits++;
+
+	return bits;
+	}
+
+std::vector<uint8_t> IntegerColumnEncoding::encode(
+						const uint8_t* data,
+						uword_t count,
+						uword_t byteWidth,
+						uword_t stride,
+						bool isSigned
+						)
+	{
+	lassert(byteWidth > 0 && byteWidth <= sizeof(uint64_t));
+
+	std::vector<uint8_t> result;
+
+	if (count == 0)
+		return result;
+
+	std::vector<uint64_t> values(count);
+
+	ValueRange valueRange(isSigned);
+
+	//differences between neighbors are always compared as signed, so that a sorted column
+	//with the occasional step backwards still gets a narrow encoding.
+	ValueRange deltaRange(true);
+
+	for (uword_t k = 0; k < count; k++)
+		{
+		values[k] = readValue(data + k * stride, byteWidth, isSigned);
+
+		valueRange.observe(values[k]);
+
+		if (k > 0)
+			deltaRange.observe(values[k] - values[k-1]);
+		}
+
+	uword_t rawBytes = count * byteWidth;
+
+	uword_t valueBits = valueRange.bitsToRepresentOffsets();
+
+	if (valueBits == 0)
+		{
+		if (1 + sizeof(uint64_t) >= rawBytes)
+			return result;
+
+		result.push_back((uint8_t)Encoding::Constant);
+		appendValue(result, values[0]);
+
+		return result;
+		}
+
+	uword_t deltaBits = deltaRange.bitsToRepresentOffsets();
+
+	uword_t frameOfReferenceBytes = 1 + sizeof(uint64_t) + 1 + bytesForBits(count * valueBits);
+
+	uword_t deltaBytes = 1 + 2 * sizeof(uint64_t) + 1 + bytesForBits((count - 1) * deltaBits);
+
+	if (std::min(frameOfReferenceBytes, deltaBytes) >= rawBytes)
+		return result;
+
+	BitWriter writer(result);
+
+	if (frameOfReferenceBytes <= deltaBytes)
+		{
+		result.push_back((uint8_t)Encoding::FrameOfReference);
+		appendValue(result, valueRange.min());
+		result.push_back(valueBits);
+
+		for (uword_t k = 0; k < count; k++)
+			writer.write(values[k] - valueRange.min(), valueBits);
+		}
+	else
+		{
+		result.push_back((uint8_t)Encoding::Delta);
+		appendValue(result, values[0]);
+		appendValue(result, deltaRange.min());
+		result.push_back(deltaBits);
+
+		for (uword_t k = 1; k < count; k++)
+			writer.write(values[k] - values[k-1] - deltaRange.min(), deltaBits);
+		}
+
+	writer.finish();
+
+	return result;
+	}
+
+void IntegerColumnEncoding::decode(
+						const uint8_t* encoded,
+						uword_t encodedBytes,
+						uint8_t* data,
+						uword_t count,
+						uword_t byteWidth,
+						uword_t stride
+						)
+	{
+	lassert(encodedBytes > 0);
+
+	const uint8_t* end = encoded + encodedBytes;
+
+	Encoding encoding = (Encoding)*encoded;
+	encoded++;
+
+	auto readHeaderValue = [&]() {
+		lassert(encoded + sizeof(uint64_t) <= end);
+
+		uint64_t value;
+		memcpy(&value, encoded, sizeof(uint64_t));
+		encoded += sizeof(uint64_t);
+
+		return value;
+		};
+
+	if (encoding == Encoding::Constant)
+		{
+		uint64_t value = readHeaderValue();
+
+		for (uword_t k = 0; k < count; k++)
+			writeValue(data + k * stride, byteWidth, value);
+		}
+		else
+	if (encoding == Encoding::FrameOfReference)
+		{
+		uint64_t minValue = readHeaderValue();
+
+		lassert(encoded < end);
+		uword_t bits = *encoded++;
+
+		BitReader reader(encoded, end);
+
+		for (uword_t k = 0; k < count; k++)
+			writeValue(data + k * stride, byteWidth, minValue + reader.read(bits));
+		}
+		else
+	if (encoding == Encoding::Delta)
+		{
+		uint64_t value = readHeaderValue();
+		uint64_t minDelta = readHeaderValue();
+
+		lassert(encoded < end);
+		uword_t bits = *encoded++;
+
+		BitReader reader(encoded, end);
+
+		for (uword_t k = 0; k < count; k++)
+			{
+			if (k > 0)
+				value += minDelta + reader.read(bits);
+
+			writeValue(data + k * stride, byteWidth, value);
+			}
+		}
+	else
+		lassert_dump(false, "unknown integer column encoding " << (int)encoding);
+	}
+
+}
+
@@ -0,0 +1,77 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "../../core/IntegerTypes.hpp"
+
+namespace Fora {
+
+/***************
+IntegerColumnEncoding
+
+Compact physical encodings for columns of fixed-width integers, used when serializing
+homogenous runs of Bool, Int, UInt, DateTime and TimeDuration values.
+
+Each value is read as a little-endian integer of 'byteWidth' bytes (sign-extended if
+'isSigned'), and the column is written in whichever of the following is smallest:
+
+	Constant            - a single value repeated 'count' times
+	FrameOfReference    - the minimum value, followed by (value - minimum) bit-packed in as
+	                      few bits as the range of the column needs. A column of Bools
+	                      becomes one bit per value.
+	Delta               - the first value, followed by a frame-of-reference encoding of the
+	                      differences between consecutive values. Sorted columns such as
+	                      timestamps compress well this way.
+
+If none of these beats writing the values out verbatim, 'encode' returns an empty buffer.
+****************/
+
+class IntegerColumnEncoding {
+public:
+	enum class Encoding {
+		Constant = 1,
+		FrameOfReference = 2,
+		Delta = 3
+	};
+
+	//encode 'count' values laid out at 'data' with the given stride. Returns an empty buffer
+	//if the encoded form wouldn't be smaller than the raw bytes.
+	static std::vector<uint8_t> encode(
+						const uint8_t* data,
+						uword_t count,
+						uword_t byteWidth,
+						uword_t stride,
+						bool isSigned
+						);
+
+	//decode the output of 'encode' back into 'count' strided values of 'byteWidth' bytes.
+	static void decode(
+						const uint8_t* encoded,
+						uword_t encodedBytes,
+						uint8_t* data,
+						uword_t count,
+						uword_t byteWidth,
+						uword_t stride
+						);
+
+	//number of bits needed to represent every value in [0, range]
+	static uword_t bitsToRepresent(uint64_t range);
+};
+
+}
+
@@ -0,0 +1,195 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "IntegerColumnEncoding.hpp"
+#include "../../core/UnitTest.hpp"
+#include <boost/random.hpp>
+
+using Fora::IntegerColumnEncoding;
+
+namespace {
+
+template<class T>
+std::vector<T> roundTrip(const std::vector<T>& values, bool isSigned, uword_t& outEncodedBytes)
+	{
+	std::vector<uint8_t> encoded =
+		IntegerColumnEncoding::encode(
+			(const uint8_t*)&values[0],
+			values.size(),
+			sizeof(T),
+			sizeof(T),
+			isSigned
+			);
+
+	outEncodedBytes = encoded.size();
+
+	if (!encoded.size())
+		return values;
+
+	std::vector<T> decoded(values.size());
+
+	IntegerColumnEncoding::decode(
+		&encoded[0],
+		encoded.size(),
+		(uint8_t*)&decoded[0],
+		decoded.size(),
+		sizeof(T),
+		sizeof(T)
+		);
+
+	return decoded;
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_IntegerColumnEncoding )
+
+BOOST_AUTO_TEST_CASE( test_bits_to_represent )
+	{
+	BOOST_CHECK_EQUAL(IntegerColumnEncoding::bitsToRepresent(0), 0);
+	BOOST_CHECK_EQUAL(IntegerColumnEncoding::bitsToRepresent(1), 1);
+	BOOST_CHECK_EQUAL(IntegerColumnEncoding::bitsToRepresent(255), 8);
+	BOOST_CHECK_EQUAL(IntegerColumnEncoding::bitsToRepresent(256), 9);
+	BOOST_CHECK_EQUAL(IntegerColumnEncoding::bitsToRepresent(~uint64_t(0)), 64);
+	}
+
+BOOST_AUTO_TEST_CASE( test_constant )
+	{
+	std::vector<int64_t> values(1000, -12345);
+
+	uword_t encodedBytes;
+
+	BOOST_CHECK(roundTrip(values, true, encodedBytes) == values);
+	BOOST_CHECK_EQUAL(encodedBytes, 1 + sizeof(uint64_t));
+	}
+
+BOOST_AUTO_TEST_CASE( test_bools_are_bit_packed )
+	{
+	std::vector<uint8_t> values;
+
+	for (long k = 0; k < 1000; k++)
+		values.push_back(k % 3 == 0 ? 1 : 0);
+
+	uword_t encodedBytes;
+
+	BOOST_CHECK(roundTrip(values, false, encodedBytes) == values);
+	BOOST_CHECK(encodedBytes <= 1000 / 8 + 16);
+	}
+
+BOOST_AUTO_TEST_CASE( test_sorted_timestamps_use_deltas )
+	{
+	std::vector<int64_t> values;
+
+	int64_t t = 1400000000000000;
+
+	boost::mt19937 generator(1);
+
+	for (long k = 0; k < 1000; k++)
+		{
+		t += 1000 + generator() % 16;
+		values.push_back(t);
+		}
+
+	uword_t encodedBytes;
+
+	BOOST_CHECK(roundTrip(values, true, encodedBytes) == values);
+
+	//deltas fit in 4 bits
+	BOOST_CHECK(encodedBytes <= 1000 * 4 / 8 + 32);
+	}
+
+BOOST_AUTO_TEST_CASE( test_negative_values )
+	{
+	std::vector<int32_t> values;
+
+	for (long k = 0; k < 1000; k++)
+		values.push_back(k % 7 - 3);
+
+	uword_t encodedBytes;
+
+	BOOST_CHECK(roundTrip(values, true, encodedBytes) == values);
+	BOOST_CHECK(encodedBytes < 1000);
+	}
+
+BOOST_AUTO_TEST_CASE( test_incompressible_values_are_left_alone )
+	{
+	std::vector<uint64_t> values;
+
+	boost::mt19937 generator(1);
+
+	for (long k = 0; k < 1000; k++)
+		values.push_back((uint64_t(generator()) << 32) + generator());
+
+	uword_t encodedBytes;
+
+	roundTrip(values, false, encodedBytes);
+
+	BOOST_CHECK_EQUAL(encodedBytes, 0);
+	}
+
+BOOST_AUTO_TEST_CASE( test_randomized_widths_and_strides )
+	{
+	boost::mt19937 generator(1);
+
+	for (long pass = 0; pass < 500; pass++)
+		{
+		uword_t byteWidth = 1 << (generator() % 4);
+		uword_t stride = byteWidth + generator() % 3;
+		uword_t count = 1 + generator() % 300;
+		bool isSigned = generator() % 2;
+
+		uword_t bitsOfNoise = generator() % (byteWidth * 8 + 1);
+		uint64_t base = (uint64_t(generator()) << 32) + generator();
+		bool sorted = generator() % 2;
+
+		std::vector<uint8_t> data(count * stride);
+
+		uint64_t cur = base;
+		for (uword_t k = 0; k < count; k++)
+			{
+			uint64_t noise = ((uint64_t(generator()) << 32) + generator()) &
+				(bitsOfNoise >= 64 ? ~uint64_t(0) : (uint64_t(1) << bitsOfNoise) - 1);
+
+			cur = sorted ? cur + noise : base + noise;
+
+			memcpy(&data[k * stride], &cur, byteWidth);
+			}
+
+		std::vector<uint8_t> encoded =
+			IntegerColumnEncoding::encode(&data[0], count, byteWidth, stride, isSigned);
+
+		if (!encoded.size())
+			continue;
+
+		BOOST_REQUIRE(encoded.size() < count * byteWidth);
+
+		std::vector<uint8_t> decoded(count * stride);
+
+		IntegerColumnEncoding::decode(
+			&encoded[0],
+			encoded.size(),
+			&decoded[0],
+			count,
+			byteWidth,
+			stride
+			);
+
+		for (uword_t k = 0; k < count; k++)
+			BOOST_REQUIRE(memcmp(&data[k * stride], &decoded[k * stride], byteWidth) == 0);
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -214,6 +214,8 @@ void SerializedObjectContextDeserializer::deserialize(boost::shared_ptr<Fora::Pa
 
 	SerializedObjectContextDeserializer newDeserializer(getStream(), mContext, &*out);
 
+	newDeserializer.setFormatVersion(getFormatVersion());
+
 		{
 		Ufora::threading::ScopedThreadLocalContext<Fora::Interpreter::ExecutionContext> setECContextToNull;
 
@@ -0,0 +1,463 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+/***************
+ColumnKernels
+
+Whole-column kernels behind the DataFrame group-by and join operations. They work on plain
+arrays of keys and values that the axioms in ColumnKernelAxioms have already copied out of
+homogenous vectors, so they know nothing about FORA values or paging.
+
+Grouping is by hashing: every row gets the index of its group, with groups numbered in the
+order their keys first appear, and the accumulators below fold each group's values in row
+order. Keys compare with '==', so a NaN key never matches anything (including itself).
+
+Big columns are grouped a slice at a time, and the per-slice tables of (key, result) merged with
+'mergeGroups', so every accumulator says how to 'combine' two of its results. Means can't be
+combined, so for those GroupBy.fora takes the SumAndCount of each group and divides.
+
+***************/
+
+class ColumnKernels {
+public:
+	//order keys by '<', putting NaNs last so that std::sort sees a strict weak ordering
+	template<class key_type>
+	static bool keyLess(key_type left, key_type right)
+		{
+		if (right != right)
+			return left == left;
+
+		return left < right;
+		}
+
+	//write the group index of each of 'count' keys into 'outGroupIds', and return the key of
+	//each group
+	template<class key_type>
+	static std::vector<key_type> groupIds(
+				const key_type* keys,
+				int64_t count,
+				std::vector<int64_t>& outGroupIds
+				)
+		{
+		boost::unordered_map<key_type, int64_t> groupIndices;
+		std::vector<key_type> groupKeys;
+
+		outGroupIds.resize(count);
+
+		for (int64_t k = 0; k < count; k++)
+			{
+			auto it = groupIndices.find(keys[k]);
+
+			if (it == groupIndices.end())
+				{
+				it = groupIndices.insert(std::make_pair(keys[k], (int64_t)groupKeys.size())).first;
+				groupKeys.push_back(keys[k]);
+				}
+
+			outGroupIds[k] = it->second;
+			}
+
+		return groupKeys;
+		}
+
+	//the permutation of 'groupKeys' that sorts them by 'keyLess'
+	template<class key_type>
+	static std::vector<int64_t> sortedGroupOrder(const std::vector<key_type>& groupKeys)
+		{
+		std::vector<int64_t> order;
+		for (int64_t k = 0; k < groupKeys.size(); k++)
+			order.push_back(k);
+
+		std::sort(
+			order.begin(),
+			order.end(),
+			[&](int64_t left, int64_t right) {
+				return keyLess(groupKeys[left], groupKeys[right]);
+				}
+			);
+
+		return order;
+		}
+
+	//fold the values of each group, in row order, with a fresh 'accumulator_type'
+	template<class accumulator_type, class value_type>
+	static std::vector<typename accumulator_type::result_type> aggregate(
+				const std::vector<int64_t>& groupIds,
+				const value_type* values,
+				int64_t groupCount
+				)
+		{
+		std::vector<accumulator_type> accumulators(groupCount);
+
+		for (int64_t k = 0; k < groupIds.size(); k++)
+			accumulators[groupIds[k]].add(values[k]);
+
+		std::vector<typename accumulator_type::result_type> results;
+		results.reserve(groupCount);
+
+		for (int64_t k = 0; k < groupCount; k++)
+			results.push_back(accumulators[k].result());
+
+		return results;
+		}
+
+	//merge two tables of groups, each sorted by 'keyLess', into 'outKeys' and 'outValues'. A key
+	//in both tables gets its two results combined with 'accumulator_type', left's first.
+	template<class accumulator_type, class key_type>
+	static void mergeGroups(
+				const std::vector<key_type>& leftKeys,
+				const std::vector<typename accumulator_type::result_type>& leftResults,
+				const std::vector<key_type>& rightKeys,
+				const std::vector<typename accumulator_type::result_type>& rightResults,
+				std::vector<key_type>& outKeys,
+				std::vector<typename accumulator_type::result_type>& outResults
+				)
+		{
+		int64_t leftIx = 0;
+		int64_t rightIx = 0;
+
+		while (leftIx < leftKeys.size() && rightIx < rightKeys.size())
+			{
+			if (leftKeys[leftIx] == rightKeys[rightIx])
+				{
+				outKeys.push_back(leftKeys[leftIx]);
+				outResults.push_back(
+					accumulator_type::combine(leftResults[leftIx], rightResults[rightIx])
+					);
+
+				leftIx++;
+				rightIx++;
+				}
+			else
+			if (!keyLess(rightKeys[rightIx], leftKeys[leftIx]))
+				{
+				outKeys.push_back(leftKeys[leftIx]);
+				outResults.push_back(leftResults[leftIx]);
+				leftIx++;
+				}
+			else
+				{
+				outKeys.push_back(rightKeys[rightIx]);
+				outResults.push_back(rightResults[rightIx]);
+				rightIx++;
+				}
+			}
+
+		for (; leftIx < leftKeys.size(); leftIx++)
+			{
+			outKeys.push_back(leftKeys[leftIx]);
+			outResults.push_back(leftResults[leftIx]);
+			}
+
+		for (; rightIx < rightKeys.size(); rightIx++)
+			{
+			outKeys.push_back(rightKeys[rightIx]);
+			outResults.push_back(rightResults[rightIx]);
+			}
+		}
+
+	static std::vector<int64_t> groupSizes(
+				const std::vector<int64_t>& groupIds,
+				int64_t groupCount
+				)
+		{
+		std::vector<int64_t> sizes(groupCount, 0);
+
+		for (int64_t k = 0; k < groupIds.size(); k++)
+			sizes[groupIds[k]]++;
+
+		return sizes;
+		}
+
+	//for each left row in order, append (leftIndex, rightIndex) to the selectors for every right
+	//row with an equal key, in right-row order. Left rows with no match contribute
+	//(leftIndex, -1) if 'keepUnmatchedLeft' and nothing otherwise.
+	template<class key_type>
+	static void hashJoinSelectors(
+				const key_type* left,
+				int64_t leftCount,
+				const key_type* right,
+				int64_t rightCount,
+				bool keepUnmatchedLeft,
+				std::vector<int64_t>& outLeftSelector,
+				std::vector<int64_t>& outRightSelector
+				)
+		{
+		//each key maps to its first right row; 'nextRow' chains the rest in order
+		boost::unordered_map<key_type, int64_t> firstRow;
+		std::vector<int64_t> nextRow(rightCount, -1);
+
+		for (int64_t k = rightCount - 1; k >= 0; k--)
+			{
+			auto it = firstRow.find(right[k]);
+
+			if (it == firstRow.end())
+				firstRow.insert(std::make_pair(right[k], k));
+			else
+				{
+				nextRow[k] = it->second;
+				it->second = k;
+				}
+			}
+
+		for (int64_t leftIx = 0; leftIx < leftCount; leftIx++)
+			{
+			auto it = firstRow.find(left[leftIx]);
+
+			if (it == firstRow.end())
+				{
+				if (keepUnmatchedLeft)
+					{
+					outLeftSelector.push_back(leftIx);
+					outRightSelector.push_back(-1);
+					}
+				}
+			else
+				for (int64_t rightIx = it->second; rightIx != -1; rightIx = nextRow[rightIx])
+					{
+					outLeftSelector.push_back(leftIx);
+					outRightSelector.push_back(rightIx);
+					}
+			}
+		}
+
+	//outer join of two key columns that are both sorted by '<'. Rows come out in key order,
+	//with -1 standing in for the missing side of an unmatched row. This is the merge that
+	//OuterJoiner.computeLeftAndRightSelectors in joining.fora performs.
+	template<class key_type>
+	static void mergeOuterJoinSelectors(
+				const key_type* left,
+				int64_t leftCount,
+				const key_type* right,
+				int64_t rightCount,
+				std::vector<int64_t>& outLeftSelector,
+				std::vector<int64_t>& outRightSelector
+				)
+		{
+		int64_t leftIx = 0;
+		int64_t rightIx = 0;
+
+		while (leftIx < leftCount && rightIx < rightCount)
+			{
+			key_type leftVal = left[leftIx];
+
+			if (leftVal < right[rightIx])
+				{
+				outLeftSelector.push_back(leftIx);
+				outRightSelector.push_back(-1);
+				leftIx++;
+				}
+			else
+			if (leftVal == right[rightIx])
+				{
+				int64_t rightCycleStart = rightIx;
+
+				while (rightIx < rightCount && right[rightIx] == leftVal)
+					{
+					outLeftSelector.push_back(leftIx);
+					outRightSelector.push_back(rightIx);
+					rightIx++;
+					}
+
+				leftIx++;
+
+				if (leftIx < leftCount && left[leftIx] == leftVal)
+					rightIx = rightCycleStart;
+				}
+			else
+				{
+				outLeftSelector.push_back(-1);
+				outRightSelector.push_back(rightIx);
+				rightIx++;
+				}
+			}
+
+		for (; leftIx < leftCount; leftIx++)
+			{
+			outLeftSelector.push_back(leftIx);
+			outRightSelector.push_back(-1);
+			}
+
+		for (; rightIx < rightCount; rightIx++)
+			{
+			outLeftSelector.push_back(-1);
+			outRightSelector.push_back(rightIx);
+			}
+		}
+
+	//accumulators for 'aggregate'
+
+	template<class value_type>
+	class Sum {
+	public:
+		typedef value_type result_type;
+
+		Sum() : mSum(0)
+			{
+			}
+
+		void add(value_type value)
+			{
+			mSum = wrappingAdd(mSum, value);
+			}
+
+		result_type result() const
+			{
+			return mSum;
+			}
+
+		static result_type combine(result_type left, result_type right)
+			{
+			return wrappingAdd(left, right);
+			}
+
+	private:
+		value_type mSum;
+	};
+
+	template<class value_type>
+	class SumAndCountResult {
+	public:
+		value_type sum;
+		int64_t count;
+	};
+
+	//the sum of a group's values and how many there are, which is what its mean is made of
+	template<class value_type>
+	class SumAndCount {
+	public:
+		typedef SumAndCountResult<value_type> result_type;
+
+		SumAndCount()
+			{
+			mResult.sum = 0;
+			mResult.count = 0;
+			}
+
+		void add(value_type value)
+			{
+			mResult.sum = wrappingAdd(mResult.sum, value);
+			mResult.count++;
+			}
+
+		result_type result() const
+			{
+			return mResult;
+			}
+
+		static result_type combine(result_type left, result_type right)
+			{
+			result_type combined;
+			combined.sum = wrappingAdd(left.sum, right.sum);
+			combined.count = left.count + right.count;
+			return combined;
+			}
+
+	private:
+		result_type mResult;
+	};
+
+	//folds 'x <<< y' (e.g. 'x < y ? x : y'), starting with the group's first value
+	template<class value_type>
+	class Min {
+	public:
+		typedef value_type result_type;
+
+		Min() : mHasValue(false), mValue(0)
+			{
+			}
+
+		void add(value_type value)
+			{
+			if (!mHasValue || !(mValue < value))
+				mValue = value;
+			mHasValue = true;
+			}
+
+		result_type result() const
+			{
+			return mValue;
+			}
+
+		static result_type combine(result_type left, result_type right)
+			{
+			Min accumulator;
+			accumulator.add(left);
+			accumulator.add(right);
+			return accumulator.result();
+			}
+
+	private:
+		bool mHasValue;
+
+		value_type mValue;
+	};
+
+	//folds 'x >>> y' (e.g. 'x > y ? x : y'), starting with the group's first value
+	template<class value_type>
+	class Max {
+	public:
+		typedef value_type result_type;
+
+		Max() : mHasValue(false), mValue(0)
+			{
+			}
+
+		void add(value_type value)
+			{
+			if (!mHasValue || !(mValue > value))
+				mValue = value;
+			mHasValue = true;
+			}
+
+		result_type result() const
+			{
+			return mValue;
+			}
+
+		static result_type combine(result_type left, result_type right)
+			{
+			Max accumulator;
+			accumulator.add(left);
+			accumulator.add(right);
+			return accumulator.result();
+			}
+
+	private:
+		bool mHasValue;
+
+		value_type mValue;
+	};
+
+private:
+	//Int64 addition in FORA wraps around on overflow
+	static int64_t wrappingAdd(int64_t left, int64_t right)
+		{
+		return (int64_t)((uint64_t)left + (uint64_t)right);
+		}
+
+	static double wrappingAdd(double left, double right)
+		{
+		return left + right;
+		}
+};
+
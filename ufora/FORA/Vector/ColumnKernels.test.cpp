@@ -0,0 +1,201 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "ColumnKernels.hpp"
+#include "../../core/UnitTest.hpp"
+#include <limits>
+#include <vector>
+
+namespace {
+
+typedef std::vector<int64_t> Selector;
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_ColumnKernels )
+
+BOOST_AUTO_TEST_CASE( test_group_ids_follow_first_appearance )
+	{
+	int64_t keys[] = { 3, 1, 3, 2, 1, 3 };
+
+	std::vector<int64_t> groupIds;
+	std::vector<int64_t> groupKeys = ColumnKernels::groupIds(keys, 6, groupIds);
+
+	BOOST_CHECK(groupKeys == std::vector<int64_t>({ 3, 1, 2 }));
+	BOOST_CHECK(groupIds == std::vector<int64_t>({ 0, 1, 0, 2, 1, 0 }));
+
+	BOOST_CHECK(ColumnKernels::sortedGroupOrder(groupKeys) == std::vector<int64_t>({ 1, 2, 0 }));
+
+	BOOST_CHECK(ColumnKernels::groupSizes(groupIds, 3) == std::vector<int64_t>({ 3, 2, 1 }));
+	}
+
+BOOST_AUTO_TEST_CASE( test_nan_keys_are_never_equal )
+	{
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	double keys[] = { nan, 1.0, nan, 0.0, -0.0 };
+
+	std::vector<int64_t> groupIds;
+	std::vector<double> groupKeys = ColumnKernels::groupIds(keys, 5, groupIds);
+
+	BOOST_CHECK_EQUAL(groupKeys.size(), 4);
+	BOOST_CHECK(groupIds == std::vector<int64_t>({ 0, 1, 2, 3, 3 }));
+
+	std::vector<int64_t> order = ColumnKernels::sortedGroupOrder(groupKeys);
+
+	BOOST_CHECK_EQUAL(order[0], 3);
+	BOOST_CHECK_EQUAL(order[1], 1);
+	}
+
+BOOST_AUTO_TEST_CASE( test_aggregate )
+	{
+	std::vector<int64_t> groupIds({ 0, 1, 0, 1, 0 });
+	double values[] = { 1.0, 10.0, 2.0, 20.0, -3.0 };
+	int64_t intValues[] = { 1, 10, std::numeric_limits<int64_t>::max(), 20, 1 };
+
+	BOOST_CHECK((ColumnKernels::aggregate<ColumnKernels::Sum<double> >(groupIds, values, 2)
+		== std::vector<double>({ 0.0, 30.0 })));
+	BOOST_CHECK((ColumnKernels::aggregate<ColumnKernels::Min<double> >(groupIds, values, 2)
+		== std::vector<double>({ -3.0, 10.0 })));
+	BOOST_CHECK((ColumnKernels::aggregate<ColumnKernels::Max<double> >(groupIds, values, 2)
+		== std::vector<double>({ 2.0, 20.0 })));
+
+	//integer sums wrap around rather than overflowing
+	BOOST_CHECK((ColumnKernels::aggregate<ColumnKernels::Sum<int64_t> >(groupIds, intValues, 2)
+		== std::vector<int64_t>({ std::numeric_limits<int64_t>::min() + 1, 30 })));
+	}
+
+BOOST_AUTO_TEST_CASE( test_merge_groups )
+	{
+	double nan = std::numeric_limits<double>::quiet_NaN();
+
+	std::vector<double> leftKeys({ 1.0, 3.0, nan });
+	std::vector<int64_t> leftResults({ 10, 30, 1 });
+	std::vector<double> rightKeys({ 2.0, 3.0, 4.0, nan });
+	std::vector<int64_t> rightResults({ 20, 5, 40, 2 });
+
+	std::vector<double> keys;
+	std::vector<int64_t> results;
+
+	ColumnKernels::mergeGroups<ColumnKernels::Sum<int64_t> >(
+		leftKeys,
+		leftResults,
+		rightKeys,
+		rightResults,
+		keys,
+		results
+		);
+
+	//NaN keys are never the same group, so both survive
+	BOOST_REQUIRE_EQUAL(keys.size(), 6);
+	BOOST_CHECK((std::vector<double>(keys.begin(), keys.begin() + 4)
+		== std::vector<double>({ 1.0, 2.0, 3.0, 4.0 })));
+	BOOST_CHECK(keys[4] != keys[4] && keys[5] != keys[5]);
+	BOOST_CHECK(results == std::vector<int64_t>({ 10, 20, 35, 40, 1, 2 }));
+
+	std::vector<double> maxKeys;
+	std::vector<int64_t> maxResults;
+
+	ColumnKernels::mergeGroups<ColumnKernels::Max<int64_t> >(
+		leftKeys,
+		leftResults,
+		rightKeys,
+		rightResults,
+		maxKeys,
+		maxResults
+		);
+
+	BOOST_CHECK(maxResults == std::vector<int64_t>({ 10, 20, 30, 40, 1, 2 }));
+	}
+
+BOOST_AUTO_TEST_CASE( test_sum_and_count )
+	{
+	typedef ColumnKernels::SumAndCount<double> accumulator_type;
+	typedef accumulator_type::result_type result_type;
+
+	double nan = std::numeric_limits<double>::quiet_NaN();
+
+	std::vector<int64_t> groupIds({ 0, 1, 0, 2, 0 });
+	double values[] = { 1.0, 10.0, 2.0, 7.0, -3.0 };
+
+	std::vector<result_type> results =
+		ColumnKernels::aggregate<accumulator_type>(groupIds, values, 3);
+
+	BOOST_REQUIRE_EQUAL(results.size(), 3);
+	BOOST_CHECK_EQUAL(results[0].sum, 0.0);
+	BOOST_CHECK_EQUAL(results[0].count, 3);
+	BOOST_CHECK_EQUAL(results[1].sum, 10.0);
+	BOOST_CHECK_EQUAL(results[1].count, 1);
+
+	//each NaN key keeps its own sum and count through a merge, whatever order they're in
+	std::vector<double> leftKeys({ 1.0, nan });
+	std::vector<result_type> leftResults({ results[0], results[1] });
+	std::vector<double> rightKeys({ 1.0, nan });
+	std::vector<result_type> rightResults({ results[2], results[0] });
+
+	std::vector<double> keys;
+	std::vector<result_type> merged;
+
+	ColumnKernels::mergeGroups<accumulator_type>(
+		leftKeys,
+		leftResults,
+		rightKeys,
+		rightResults,
+		keys,
+		merged
+		);
+
+	BOOST_REQUIRE_EQUAL(keys.size(), 3);
+	BOOST_CHECK_EQUAL(keys[0], 1.0);
+	BOOST_CHECK_EQUAL(merged[0].sum, 7.0);
+	BOOST_CHECK_EQUAL(merged[0].count, 4);
+	BOOST_CHECK_EQUAL(merged[1].sum, 10.0);
+	BOOST_CHECK_EQUAL(merged[1].count, 1);
+	BOOST_CHECK_EQUAL(merged[2].sum, 0.0);
+	BOOST_CHECK_EQUAL(merged[2].count, 3);
+	}
+
+BOOST_AUTO_TEST_CASE( test_hash_join_selectors )
+	{
+	int64_t left[] = { 1, 2, 2, 4 };
+	int64_t right[] = { 2, 3, 2, 1 };
+
+	Selector leftSelector, rightSelector;
+	ColumnKernels::hashJoinSelectors(left, 4, right, 4, false, leftSelector, rightSelector);
+
+	BOOST_CHECK(leftSelector == Selector({ 0, 1, 1, 2, 2 }));
+	BOOST_CHECK(rightSelector == Selector({ 3, 0, 2, 0, 2 }));
+
+	leftSelector.clear();
+	rightSelector.clear();
+	ColumnKernels::hashJoinSelectors(left, 4, right, 4, true, leftSelector, rightSelector);
+
+	BOOST_CHECK(leftSelector == Selector({ 0, 1, 1, 2, 2, 3 }));
+	BOOST_CHECK(rightSelector == Selector({ 3, 0, 2, 0, 2, -1 }));
+	}
+
+BOOST_AUTO_TEST_CASE( test_merge_outer_join_selectors )
+	{
+	int64_t left[] = { 1, 2, 2, 5 };
+	int64_t right[] = { 0, 2, 2, 3, 5, 6 };
+
+	Selector leftSelector, rightSelector;
+	ColumnKernels::mergeOuterJoinSelectors(left, 4, right, 6, leftSelector, rightSelector);
+
+	BOOST_CHECK(leftSelector == Selector({ -1, 0, 1, 1, 2, 2, -1, 3, -1 }));
+	BOOST_CHECK(rightSelector == Selector({ 0, -1, 1, 2, 1, 2, 3, 4, 5 }));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,190 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Float64VectorKernels.hpp"
+
+namespace {
+
+const static int64_t kLanes = 4;
+
+inline double valueAt(const uint8_t* data, int64_t index, int64_t strideBytes)
+	{
+	return *(const double*)(data + index * strideBytes);
+	}
+
+inline bool isContiguous(int64_t strideBytes)
+	{
+	return strideBytes == sizeof(double);
+	}
+
+inline double lesserOf(double x, double y)
+	{
+	return x < y ? x : y;
+	}
+
+inline double greaterOf(double x, double y)
+	{
+	return x > y ? x : y;
+	}
+
+template<class compare_type>
+double foldSequentially(
+			double initial,
+			const uint8_t* data,
+			int64_t count,
+			int64_t strideBytes,
+			const compare_type& compare
+			)
+	{
+	double result = initial;
+
+	for (int64_t k = 0; k < count; k++)
+		result = compare(result, valueAt(data, k, strideBytes));
+
+	return result;
+	}
+
+//fold 'compare' across kLanes independent lanes. This only agrees with the left-to-right fold
+//if no NaN shows up and the winner isn't a zero (whose sign depends on which of several equal
+//zeros the sequential fold kept), so in those cases we redo the work sequentially.
+template<class compare_type>
+double foldContiguous(
+			double initial,
+			const double* values,
+			int64_t count,
+			const compare_type& compare
+			)
+	{
+	double lanes[kLanes];
+	for (int64_t l = 0; l < kLanes; l++)
+		lanes[l] = initial;
+
+	int64_t nanCount = (initial != initial ? 1 : 0);
+
+	int64_t k = 0;
+	for (; k + kLanes <= count; k += kLanes)
+		for (int64_t l = 0; l < kLanes; l++)
+			{
+			double x = values[k + l];
+			nanCount += (x != x ? 1 : 0);
+			lanes[l] = compare(lanes[l], x);
+			}
+
+	double result = lanes[0];
+	for (int64_t l = 1; l < kLanes; l++)
+		result = compare(result, lanes[l]);
+
+	for (; k < count; k++)
+		{
+		double x = values[k];
+		nanCount += (x != x ? 1 : 0);
+		result = compare(result, x);
+		}
+
+	if (nanCount || result == 0.0)
+		return foldSequentially(initial, (const uint8_t*)values, count, sizeof(double), compare);
+
+	return result;
+	}
+
+}
+
+double Float64VectorKernels::sum(const uint8_t* data, int64_t count, int64_t strideBytes)
+	{
+	if (!isContiguous(strideBytes))
+		{
+		double result = 0.0;
+		for (int64_t k = 0; k < count; k++)
+			result += valueAt(data, k, strideBytes);
+		return result;
+		}
+
+	const double* values = (const double*)data;
+
+	double lanes[kLanes] = {0.0, 0.0, 0.0, 0.0};
+
+	int64_t k = 0;
+	for (; k + kLanes <= count; k += kLanes)
+		for (int64_t l = 0; l < kLanes; l++)
+			lanes[l] += values[k + l];
+
+	double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+	for (; k < count; k++)
+		result += values[k];
+
+	return result;
+	}
+
+double Float64VectorKernels::dot(
+			const uint8_t* left,
+			int64_t leftStrideBytes,
+			const uint8_t* right,
+			int64_t rightStrideBytes,
+			int64_t count
+			)
+	{
+	if (!isContiguous(leftStrideBytes) || !isContiguous(rightStrideBytes))
+		{
+		double result = 0.0;
+		for (int64_t k = 0; k < count; k++)
+			result += valueAt(left, k, leftStrideBytes) * valueAt(right, k, rightStrideBytes);
+		return result;
+		}
+
+	const double* leftValues = (const double*)left;
+	const double* rightValues = (const double*)right;
+
+	double lanes[kLanes] = {0.0, 0.0, 0.0, 0.0};
+
+	int64_t k = 0;
+	for (; k + kLanes <= count; k += kLanes)
+		for (int64_t l = 0; l < kLanes; l++)
+			lanes[l] += leftValues[k + l] * rightValues[k + l];
+
+	double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+	for (; k < count; k++)
+		result += leftValues[k] * rightValues[k];
+
+	return result;
+	}
+
+double Float64VectorKernels::min(
+			double initial,
+			const uint8_t* data,
+			int64_t count,
+			int64_t strideBytes
+			)
+	{
+	if (!isContiguous(strideBytes))
+		return foldSequentially(initial, data, count, strideBytes, lesserOf);
+
+	return foldContiguous(initial, (const double*)data, count, lesserOf);
+	}
+
+double Float64VectorKernels::max(
+			double initial,
+			const uint8_t* data,
+			int64_t count,
+			int64_t strideBytes
+			)
+	{
+	if (!isContiguous(strideBytes))
+		return foldSequentially(initial, data, count, strideBytes, greaterOf);
+
+	return foldContiguous(initial, (const double*)data, count, greaterOf);
+	}
+
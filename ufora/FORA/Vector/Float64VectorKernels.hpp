@@ -0,0 +1,53 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+/***************
+Float64VectorKernels
+
+Bulk kernels over runs of Float64 values, used by the Vector axioms once they've found a loaded,
+homogenous slice of a vector. Each run is described by a pointer to its first value, a value
+count, and the distance in bytes between consecutive values (which may be negative, or larger
+than a double if the vector is strided or the values are packed next to other data).
+
+Contiguous runs are unrolled across several independent accumulators so that the compiler can
+keep them in SIMD registers. This reassociates 'sum' and 'dot', exactly as splitting the vector
+across threads already does. 'min' and 'max' produce the same result as folding FORA's '<<<' and
+'>>>' operators left-to-right, including the way those operators treat NaN.
+
+***************/
+
+class Float64VectorKernels {
+public:
+	static double sum(const uint8_t* data, int64_t count, int64_t strideBytes);
+
+	static double dot(
+			const uint8_t* left,
+			int64_t leftStrideBytes,
+			const uint8_t* right,
+			int64_t rightStrideBytes,
+			int64_t count
+			);
+
+	//fold 'x <<< y' (e.g. 'x < y ? x : y') over 'initial' and the values
+	static double min(double initial, const uint8_t* data, int64_t count, int64_t strideBytes);
+
+	//fold 'x >>> y' (e.g. 'x > y ? x : y') over 'initial' and the values
+	static double max(double initial, const uint8_t* data, int64_t count, int64_t strideBytes);
+};
+
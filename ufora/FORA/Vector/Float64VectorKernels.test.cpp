@@ -0,0 +1,186 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Float64VectorKernels.hpp"
+#include "../../core/UnitTest.hpp"
+#include <boost/random.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+const uint8_t* bytes(const std::vector<double>& values, int64_t offset = 0)
+	{
+	return (const uint8_t*)&values[0] + offset * sizeof(double);
+	}
+
+std::vector<double> randomValues(long count, long seed)
+	{
+	boost::mt19937 generator(seed);
+	boost::uniform_real<> distribution(-1000.0, 1000.0);
+
+	std::vector<double> values;
+	for (long k = 0; k < count; k++)
+		values.push_back(distribution(generator));
+
+	return values;
+	}
+
+double sequentialMin(double initial, const std::vector<double>& values)
+	{
+	double result = initial;
+	for (long k = 0; k < values.size(); k++)
+		result = result < values[k] ? result : values[k];
+	return result;
+	}
+
+double sequentialMax(double initial, const std::vector<double>& values)
+	{
+	double result = initial;
+	for (long k = 0; k < values.size(); k++)
+		result = result > values[k] ? result : values[k];
+	return result;
+	}
+
+bool identical(double x, double y)
+	{
+	if (x != x || y != y)
+		return x != x && y != y;
+
+	return x == y && std::signbit(x) == std::signbit(y);
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_Float64VectorKernels )
+
+BOOST_AUTO_TEST_CASE( test_sum_and_dot )
+	{
+	for (long count = 1; count < 40; count++)
+		{
+		std::vector<double> left = randomValues(count, count);
+		std::vector<double> right = randomValues(count, count + 1000);
+
+		double sum = 0.0;
+		double dot = 0.0;
+		for (long k = 0; k < count; k++)
+			{
+			sum += left[k];
+			dot += left[k] * right[k];
+			}
+
+		BOOST_CHECK_SMALL(
+			Float64VectorKernels::sum(bytes(left), count, sizeof(double)) - sum,
+			1e-8
+			);
+		BOOST_CHECK_SMALL(
+			Float64VectorKernels::dot(bytes(left), sizeof(double), bytes(right), sizeof(double), count) - dot,
+			1e-6
+			);
+		}
+
+	BOOST_CHECK_EQUAL(Float64VectorKernels::sum(0, 0, sizeof(double)), 0.0);
+	}
+
+BOOST_AUTO_TEST_CASE( test_strided_runs )
+	{
+	std::vector<double> values = randomValues(100, 1);
+
+	double evens = 0.0;
+	double evensDotReversedOdds = 0.0;
+	std::vector<double> evenValues;
+
+	for (long k = 0; k < 50; k++)
+		{
+		evens += values[k * 2];
+		evensDotReversedOdds += values[k * 2] * values[99 - k * 2];
+		evenValues.push_back(values[k * 2]);
+		}
+
+	BOOST_CHECK_SMALL(
+		Float64VectorKernels::sum(bytes(values), 50, 2 * sizeof(double)) - evens,
+		1e-8
+		);
+
+	BOOST_CHECK_SMALL(
+		Float64VectorKernels::dot(
+			bytes(values),
+			2 * sizeof(double),
+			bytes(values, 99),
+			-2 * (int64_t)sizeof(double),
+			50
+			) - evensDotReversedOdds,
+		1e-6
+		);
+
+	BOOST_CHECK_EQUAL(
+		Float64VectorKernels::min(1e10, bytes(values), 50, 2 * sizeof(double)),
+		sequentialMin(1e10, evenValues)
+		);
+	BOOST_CHECK_EQUAL(
+		Float64VectorKernels::max(-1e10, bytes(values), 50, 2 * sizeof(double)),
+		sequentialMax(-1e10, evenValues)
+		);
+	}
+
+BOOST_AUTO_TEST_CASE( test_min_and_max_agree_with_sequential_fold )
+	{
+	double nan = std::numeric_limits<double>::quiet_NaN();
+
+	std::vector<std::vector<double> > cases;
+
+	cases.push_back(randomValues(37, 2));
+	cases.push_back(randomValues(64, 3));
+
+	std::vector<double> withNan = randomValues(37, 4);
+	withNan[11] = nan;
+	cases.push_back(withNan);
+
+	std::vector<double> endsInNan = randomValues(21, 5);
+	endsInNan.back() = nan;
+	cases.push_back(endsInNan);
+
+	std::vector<double> zeros;
+	for (long k = 0; k < 19; k++)
+		zeros.push_back(k % 3 ? 0.0 : -0.0);
+	cases.push_back(zeros);
+
+	for (long c = 0; c < cases.size(); c++)
+		{
+		const std::vector<double>& values = cases[c];
+
+		for (long initialIx = 0; initialIx < 3; initialIx++)
+			{
+			double initial = (initialIx == 0 ? values[0] : initialIx == 1 ? nan : 0.0);
+
+			BOOST_CHECK(
+				identical(
+					Float64VectorKernels::min(initial, bytes(values), values.size(), sizeof(double)),
+					sequentialMin(initial, values)
+					)
+				);
+			BOOST_CHECK(
+				identical(
+					Float64VectorKernels::max(initial, bytes(values), values.size(), sizeof(double)),
+					sequentialMax(initial, values)
+					)
+				);
+			}
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
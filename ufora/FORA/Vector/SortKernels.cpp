@@ -0,0 +1,267 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "SortKernels.hpp"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+const static uint64_t kSignBit = uint64_t(1) << 63;
+
+const static uint64_t kQuietNaN = 0x7FF8000000000000ULL;
+
+//map values to unsigned integers that sort the same way
+inline uint64_t radixKey(int64_t value)
+	{
+	return (uint64_t)value ^ kSignBit;
+	}
+
+inline void fromRadixKey(uint64_t key, int64_t& outValue)
+	{
+	outValue = (int64_t)(key ^ kSignBit);
+	}
+
+inline uint64_t radixKey(double value)
+	{
+	//-0.0 == 0.0, so they get the same key and keep their order like any other equal values
+	if (value == 0)
+		value = 0;
+
+	uint64_t bits = kQuietNaN;
+
+	if (value == value)
+		memcpy(&bits, &value, sizeof(double));
+
+	//negative values sort in reverse order of their bits, and below all the positive ones
+	if (bits & kSignBit)
+		return ~bits;
+
+	return bits | kSignBit;
+	}
+
+//stable LSD radix sort of 'keys', moving 'payload' (if it isn't null) along with them
+void radixSort(uint64_t* keys, int64_t* payload, int64_t count)
+	{
+	if (count < 2)
+		return;
+
+	std::vector<int64_t> histograms(8 * 256, 0);
+
+	for (int64_t k = 0; k < count; k++)
+		for (long byte = 0; byte < 8; byte++)
+			histograms[byte * 256 + ((keys[k] >> (byte * 8)) & 0xFF)]++;
+
+	std::vector<uint64_t> keyBuffer(count);
+	std::vector<int64_t> payloadBuffer(payload ? count : 0);
+
+	uint64_t* sourceKeys = keys;
+	uint64_t* destKeys = &keyBuffer[0];
+	int64_t* sourcePayload = payload;
+	int64_t* destPayload = payload ? &payloadBuffer[0] : 0;
+
+	for (long byte = 0; byte < 8; byte++)
+		{
+		int64_t* histogram = &histograms[byte * 256];
+
+		//every key has the same byte here, so this pass wouldn't move anything
+		if (histogram[(sourceKeys[0] >> (byte * 8)) & 0xFF] == count)
+			continue;
+
+		int64_t offsets[256];
+		int64_t total = 0;
+		for (long bucket = 0; bucket < 256; bucket++)
+			{
+			offsets[bucket] = total;
+			total += histogram[bucket];
+			}
+
+		for (int64_t k = 0; k < count; k++)
+			{
+			int64_t target = offsets[(sourceKeys[k] >> (byte * 8)) & 0xFF]++;
+
+			destKeys[target] = sourceKeys[k];
+			if (payload)
+				destPayload[target] = sourcePayload[k];
+			}
+
+		std::swap(sourceKeys, destKeys);
+		std::swap(sourcePayload, destPayload);
+		}
+
+	if (sourceKeys != keys)
+		{
+		memcpy(keys, sourceKeys, count * sizeof(uint64_t));
+		if (payload)
+			memcpy(payload, sourcePayload, count * sizeof(int64_t));
+		}
+	}
+
+template<class T>
+void sortValues(T* values, int64_t count)
+	{
+	std::vector<uint64_t> keys(count);
+
+	for (int64_t k = 0; k < count; k++)
+		keys[k] = radixKey(values[k]);
+
+	radixSort(keys.data(), 0, count);
+
+	for (int64_t k = 0; k < count; k++)
+		fromRadixKey(keys[k], values[k]);
+	}
+
+//the two zeros share a key, so doubles can't be rebuilt from their keys. Carry their bits
+//through the sort instead.
+void sortValues(double* values, int64_t count)
+	{
+	std::vector<uint64_t> keys(count);
+	std::vector<int64_t> bits(count);
+
+	for (int64_t k = 0; k < count; k++)
+		{
+		keys[k] = radixKey(values[k]);
+		memcpy(&bits[k], &values[k], sizeof(double));
+		}
+
+	radixSort(keys.data(), bits.data(), count);
+
+	memcpy(values, bits.data(), count * sizeof(double));
+	}
+
+template<class T>
+void sortIndexedValues(SortKernels::Indexed<T>* values, int64_t count)
+	{
+	std::vector<uint64_t> keys(count);
+	std::vector<int64_t> positions(count);
+
+	for (int64_t k = 0; k < count; k++)
+		{
+		keys[k] = radixKey(values[k].value);
+		positions[k] = k;
+		}
+
+	radixSort(keys.data(), positions.data(), count);
+
+	std::vector<SortKernels::Indexed<T> > sorted(count);
+
+	for (int64_t k = 0; k < count; k++)
+		sorted[k] = values[positions[k]];
+
+	std::copy(sorted.begin(), sorted.end(), values);
+	}
+
+template<class T>
+bool valueLess(T left, T right)
+	{
+	return radixKey(left) < radixKey(right);
+	}
+
+template<class T>
+bool indexedLess(const SortKernels::Indexed<T>& left, const SortKernels::Indexed<T>& right)
+	{
+	uint64_t leftKey = radixKey(left.value);
+	uint64_t rightKey = radixKey(right.value);
+
+	return leftKey < rightKey || (leftKey == rightKey && left.index < right.index);
+	}
+
+}
+
+void SortKernels::sort(int64_t* values, int64_t count)
+	{
+	sortValues(values, count);
+	}
+
+void SortKernels::sort(double* values, int64_t count)
+	{
+	sortValues(values, count);
+	}
+
+void SortKernels::sort(Indexed<int64_t>* values, int64_t count)
+	{
+	sortIndexedValues(values, count);
+	}
+
+void SortKernels::sort(Indexed<double>* values, int64_t count)
+	{
+	sortIndexedValues(values, count);
+	}
+
+bool SortKernels::less(int64_t left, int64_t right)
+	{
+	return valueLess(left, right);
+	}
+
+bool SortKernels::less(double left, double right)
+	{
+	return valueLess(left, right);
+	}
+
+bool SortKernels::less(const Indexed<int64_t>& left, const Indexed<int64_t>& right)
+	{
+	return indexedLess(left, right);
+	}
+
+bool SortKernels::less(const Indexed<double>& left, const Indexed<double>& right)
+	{
+	return indexedLess(left, right);
+	}
+
+void SortKernels::merge(
+			const int64_t* left,
+			int64_t leftCount,
+			const int64_t* right,
+			int64_t rightCount,
+			int64_t* out
+			)
+	{
+	std::merge(left, left + leftCount, right, right + rightCount, out, valueLess<int64_t>);
+	}
+
+void SortKernels::merge(
+			const double* left,
+			int64_t leftCount,
+			const double* right,
+			int64_t rightCount,
+			double* out
+			)
+	{
+	std::merge(left, left + leftCount, right, right + rightCount, out, valueLess<double>);
+	}
+
+void SortKernels::merge(
+			const Indexed<int64_t>* left,
+			int64_t leftCount,
+			const Indexed<int64_t>* right,
+			int64_t rightCount,
+			Indexed<int64_t>* out
+			)
+	{
+	std::merge(left, left + leftCount, right, right + rightCount, out, indexedLess<int64_t>);
+	}
+
+void SortKernels::merge(
+			const Indexed<double>* left,
+			int64_t leftCount,
+			const Indexed<double>* right,
+			int64_t rightCount,
+			Indexed<double>* out
+			)
+	{
+	std::merge(left, left + leftCount, right, right + rightCount, out, indexedLess<double>);
+	}
+
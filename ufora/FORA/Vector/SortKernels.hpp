@@ -0,0 +1,99 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+/***************
+SortKernels
+
+Sorting and merging kernels for runs of Int64 and Float64 values, used by the Vector sort
+axioms. Values are ordered by '<', with NaNs after everything else. -0.0 and 0.0 are equal, so
+they keep the order they came in.
+
+'sort' is an LSD radix sort over the 64 bits of each value (after mapping them to unsigned
+integers that order the same way), so its cost doesn't depend on the data and it's stable. Each
+pass is skipped if every value has the same byte in that position, which makes small integers
+cheap.
+
+'Indexed' values pair a value with its index in the vector it came from. Those are ordered by
+value and then by index, which is what a stable argsort needs: sorting a run whose indices are
+increasing, or merging two sorted runs, keeps equal values in index order.
+
+***************/
+
+class SortKernels {
+public:
+	template<class T>
+	class Indexed {
+	public:
+		T value;
+		int64_t index;
+	};
+
+	static void sort(int64_t* values, int64_t count);
+
+	static void sort(double* values, int64_t count);
+
+	//sort by value, keeping equal values in the order they came in
+	static void sort(Indexed<int64_t>* values, int64_t count);
+
+	static void sort(Indexed<double>* values, int64_t count);
+
+	//the ordering the kernels use. Code that splits sorted runs itself (say, to merge their
+	//halves in parallel) has to split them with this, not '<', or NaNs end up out of place.
+	static bool less(int64_t left, int64_t right);
+
+	static bool less(double left, double right);
+
+	static bool less(const Indexed<int64_t>& left, const Indexed<int64_t>& right);
+
+	static bool less(const Indexed<double>& left, const Indexed<double>& right);
+
+	//merge two sorted runs into 'out', taking from 'left' first when values are equal
+	static void merge(
+			const int64_t* left,
+			int64_t leftCount,
+			const int64_t* right,
+			int64_t rightCount,
+			int64_t* out
+			);
+
+	static void merge(
+			const double* left,
+			int64_t leftCount,
+			const double* right,
+			int64_t rightCount,
+			double* out
+			);
+
+	static void merge(
+			const Indexed<int64_t>* left,
+			int64_t leftCount,
+			const Indexed<int64_t>* right,
+			int64_t rightCount,
+			Indexed<int64_t>* out
+			);
+
+	static void merge(
+			const Indexed<double>* left,
+			int64_t leftCount,
+			const Indexed<double>* right,
+			int64_t rightCount,
+			Indexed<double>* out
+			);
+};
+
@@ -0,0 +1,242 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "SortKernels.hpp"
+#include "../../core/UnitTest.hpp"
+#include <boost/random.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+std::vector<int64_t> randomIntegers(long count, long seed, int64_t low, int64_t high)
+	{
+	boost::mt19937 generator(seed);
+	boost::uniform_int<int64_t> distribution(low, high);
+
+	std::vector<int64_t> values;
+	for (long k = 0; k < count; k++)
+		values.push_back(distribution(generator));
+
+	return values;
+	}
+
+std::vector<double> randomDoubles(long count, long seed)
+	{
+	boost::mt19937 generator(seed);
+	boost::uniform_real<> distribution(-1000.0, 1000.0);
+
+	std::vector<double> values;
+	for (long k = 0; k < count; k++)
+		values.push_back(distribution(generator));
+
+	return values;
+	}
+
+template<class T>
+std::vector<SortKernels::Indexed<T> > indexed(const std::vector<T>& values)
+	{
+	std::vector<SortKernels::Indexed<T> > result;
+	for (long k = 0; k < values.size(); k++)
+		result.push_back(SortKernels::Indexed<T>{values[k], k});
+	return result;
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_SortKernels )
+
+BOOST_AUTO_TEST_CASE( test_sort_integers )
+	{
+	for (long count = 0; count < 300; count += 7)
+		{
+		std::vector<int64_t> values = randomIntegers(count, count, -1000000000000LL, 1000000000000LL);
+		std::vector<int64_t> expected = values;
+		std::sort(expected.begin(), expected.end());
+
+		SortKernels::sort(values.data(), values.size());
+
+		BOOST_CHECK(values == expected);
+		}
+
+	std::vector<int64_t> extremes({
+		std::numeric_limits<int64_t>::max(), 0, -1, std::numeric_limits<int64_t>::min(), 1
+		});
+
+	SortKernels::sort(extremes.data(), extremes.size());
+
+	BOOST_CHECK(extremes == std::vector<int64_t>({
+		std::numeric_limits<int64_t>::min(), -1, 0, 1, std::numeric_limits<int64_t>::max()
+		}));
+	}
+
+BOOST_AUTO_TEST_CASE( test_sort_doubles )
+	{
+	std::vector<double> values = randomDoubles(1000, 1);
+	std::vector<double> expected = values;
+	std::sort(expected.begin(), expected.end());
+
+	SortKernels::sort(values.data(), values.size());
+
+	BOOST_CHECK(values == expected);
+
+	double inf = std::numeric_limits<double>::infinity();
+	double nan = std::numeric_limits<double>::quiet_NaN();
+
+	std::vector<double> special({ nan, 1.0, -inf, inf, -2.5, -nan, 0.0 });
+
+	SortKernels::sort(special.data(), special.size());
+
+	BOOST_CHECK_EQUAL(special[0], -inf);
+	BOOST_CHECK_EQUAL(special[1], -2.5);
+	BOOST_CHECK_EQUAL(special[2], 0.0);
+	BOOST_CHECK_EQUAL(special[3], 1.0);
+	BOOST_CHECK_EQUAL(special[4], inf);
+	BOOST_CHECK(std::isnan(special[5]) && std::isnan(special[6]));
+	}
+
+BOOST_AUTO_TEST_CASE( test_indexed_sort_is_stable )
+	{
+	//lots of repeated values
+	std::vector<int64_t> values = randomIntegers(5000, 2, -10, 10);
+
+	std::vector<SortKernels::Indexed<int64_t> > sorted = indexed(values);
+	SortKernels::sort(sorted.data(), sorted.size());
+
+	for (long k = 0; k < sorted.size(); k++)
+		BOOST_REQUIRE_EQUAL(sorted[k].value, values[sorted[k].index]);
+
+	for (long k = 1; k < sorted.size(); k++)
+		BOOST_REQUIRE(
+			sorted[k - 1].value < sorted[k].value ||
+			(sorted[k - 1].value == sorted[k].value && sorted[k - 1].index < sorted[k].index)
+			);
+	}
+
+BOOST_AUTO_TEST_CASE( test_merge )
+	{
+	std::vector<double> left = randomDoubles(300, 3);
+	std::vector<double> right = randomDoubles(500, 4);
+
+	SortKernels::sort(left.data(), left.size());
+	SortKernels::sort(right.data(), right.size());
+
+	std::vector<double> merged(left.size() + right.size());
+	SortKernels::merge(left.data(), left.size(), right.data(), right.size(), merged.data());
+
+	std::vector<double> expected = left;
+	expected.insert(expected.end(), right.begin(), right.end());
+	std::sort(expected.begin(), expected.end());
+
+	BOOST_CHECK(merged == expected);
+	}
+
+BOOST_AUTO_TEST_CASE( test_indexed_merge_matches_indexed_sort )
+	{
+	std::vector<int64_t> values = randomIntegers(1000, 5, 0, 20);
+
+	std::vector<SortKernels::Indexed<int64_t> > all = indexed(values);
+	std::vector<SortKernels::Indexed<int64_t> > left(all.begin(), all.begin() + 400);
+	std::vector<SortKernels::Indexed<int64_t> > right(all.begin() + 400, all.end());
+
+	SortKernels::sort(all.data(), all.size());
+	SortKernels::sort(left.data(), left.size());
+	SortKernels::sort(right.data(), right.size());
+
+	std::vector<SortKernels::Indexed<int64_t> > merged(all.size());
+	SortKernels::merge(left.data(), left.size(), right.data(), right.size(), merged.data());
+
+	for (long k = 0; k < all.size(); k++)
+		{
+		BOOST_REQUIRE_EQUAL(merged[k].value, all[k].value);
+		BOOST_REQUIRE_EQUAL(merged[k].index, all[k].index);
+		}
+	}
+
+BOOST_AUTO_TEST_CASE( test_less_orders_nans_last )
+	{
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	double inf = std::numeric_limits<double>::infinity();
+
+	BOOST_CHECK(SortKernels::less(inf, nan));
+	BOOST_CHECK(!SortKernels::less(nan, inf));
+	BOOST_CHECK(!SortKernels::less(nan, nan));
+	BOOST_CHECK(!SortKernels::less(-0.0, 0.0));
+	BOOST_CHECK(!SortKernels::less(0.0, -0.0));
+
+	//splitting [5, NaN, NaN] against [1] has to put 1 before the 5, and NaN after it
+	std::vector<double> left;
+	left.push_back(5);
+	left.push_back(nan);
+	left.push_back(nan);
+
+	bool (*less)(double, double) = &SortKernels::less;
+
+	BOOST_CHECK_EQUAL(std::lower_bound(left.begin(), left.end(), 1.0, less) - left.begin(), 0);
+	BOOST_CHECK_EQUAL(std::upper_bound(left.begin(), left.end(), nan, less) - left.begin(), 3);
+
+	SortKernels::Indexed<double> nanFirst = { nan, 0 };
+	SortKernels::Indexed<double> nanSecond = { nan, 1 };
+	SortKernels::Indexed<double> five = { 5, 2 };
+
+	BOOST_CHECK(SortKernels::less(nanFirst, nanSecond));
+	BOOST_CHECK(!SortKernels::less(nanSecond, nanFirst));
+	BOOST_CHECK(SortKernels::less(five, nanFirst));
+	BOOST_CHECK(!SortKernels::less(nanFirst, five));
+	}
+
+BOOST_AUTO_TEST_CASE( test_signed_zeros_are_equal )
+	{
+	//'<' says -0.0 and 0.0 are equal, so they keep their order and their signs
+	std::vector<double> values({ 0.0, -0.0, 1.0, -1.0, -0.0, 0.0 });
+
+	std::vector<double> sorted = values;
+	SortKernels::sort(sorted.data(), sorted.size());
+
+	BOOST_CHECK_EQUAL(sorted[0], -1.0);
+	BOOST_CHECK(sorted[1] == 0.0 && !std::signbit(sorted[1]));
+	BOOST_CHECK(sorted[2] == 0.0 && std::signbit(sorted[2]));
+	BOOST_CHECK(sorted[3] == 0.0 && std::signbit(sorted[3]));
+	BOOST_CHECK(sorted[4] == 0.0 && !std::signbit(sorted[4]));
+	BOOST_CHECK_EQUAL(sorted[5], 1.0);
+
+	std::vector<SortKernels::Indexed<double> > sortedIndexed = indexed(values);
+	SortKernels::sort(sortedIndexed.data(), sortedIndexed.size());
+
+	int64_t expectedIndices[] = { 3, 0, 1, 4, 5, 2 };
+
+	for (long k = 0; k < values.size(); k++)
+		{
+		BOOST_CHECK_EQUAL(sortedIndexed[k].index, expectedIndices[k]);
+		BOOST_CHECK_EQUAL(
+			std::signbit(sortedIndexed[k].value),
+			std::signbit(values[sortedIndexed[k].index])
+			);
+		}
+
+	//merging takes equal zeros from the left first
+	std::vector<double> left({ -0.0 });
+	std::vector<double> right({ 0.0 });
+	std::vector<double> merged(2);
+
+	SortKernels::merge(right.data(), 1, left.data(), 1, merged.data());
+
+	BOOST_CHECK(!std::signbit(merged[0]) && std::signbit(merged[1]));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -12,6 +12,7 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import base64
 import unittest
 import numpy
 import ufora.native.Cumulus as CumulusNative
@@ -94,6 +95,26 @@ class TestVectorDataManager(unittest.TestCase):
         numpytest("Vector.range(1000.0)", 'double', numpy.ones(1000).cumsum() - 1)
         numpytest("Vector.range(1000.0).paged", 'double', numpy.ones(1000).cumsum() - 1)
 
+    def test_extract_base64_matches_numpy(self):
+        vdm = self.evaluator.getVDM()
+
+        for text in ["Vector.range(1000)",
+                     "Vector.range(1000.0).paged",
+                     "(Vector.range(500).paged + Vector.range((500,1000)).paged)[1,,3]",
+                     "[(1,2.0), (3,4.0)]"]:
+            array = FORA.extractImplValContainer(FORA.eval(text))
+            size = array.getVectorSize()
+
+            nArray = vdm.extractVectorContentsAsNumpyArray(array, 0, size)
+            encoded = vdm.extractVectorContentsAsBase64(array, 1, size)
+
+            self.assertEqual(vdm.vectorNumpyDtype(array), nArray.dtype)
+            self.assertEqual(base64.b64decode(encoded), nArray[1:].tostring(), text)
+
+        array = FORA.extractImplValContainer(FORA.eval("[1,2,(3,4,5)]"))
+        self.assertTrue(vdm.extractVectorContentsAsBase64(array, 0, array.getVectorSize()) is None)
+        self.assertTrue(vdm.vectorNumpyDtype(array) is None)
+
     def test_extract_nonhomogenous_numpy_array_fails(self):
         array = FORA.extractImplValContainer(FORA.eval("[1,2,(3,4,5)]"))
         self.assertTrue(
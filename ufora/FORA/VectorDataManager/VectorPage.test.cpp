@@ -178,6 +178,67 @@ BOOST_AUTO_TEST_CASE( test_page_serialization_of_strings )
 	}
 
 
+BOOST_AUTO_TEST_CASE( test_page_serialized_in_original_format_still_deserializes )
+	{
+	PolymorphicSharedPtr<VectorDataManager> vdm(new VectorDataManager(scheduler, 1024 * 1024));
+
+	boost::shared_ptr<VectorPage> page(new VectorPage(vdm->getMemoryManager()));
+
+	//long enough runs that the current format dictionary-encodes the strings and packs the
+	//integers, neither of which format 0 does
+	boost::shared_ptr<Fora::Pagelet> strings(new Fora::Pagelet(vdm->getMemoryManager()));
+	boost::shared_ptr<Fora::Pagelet> integers(new Fora::Pagelet(vdm->getMemoryManager()));
+
+	for (long k = 0; k < 1000; k++)
+		{
+		std::string value = "a string that's too long to pack " + boost::lexical_cast<std::string>(k % 10);
+
+		strings->getValues()->append(ImplValContainer(CSTValue(value)));
+		}
+
+	int64_t* values = (int64_t*)integers->getValues()->appendUninitialized(
+		JOV::OfType(Type::Integer(64,true)),
+		1000
+		).data();
+
+	for (long k = 0; k < 1000; k++)
+		values[k] = 1000000 + k;
+
+	strings->freeze();
+	integers->freeze();
+
+	page->appendPagelet(strings);
+	page->appendPagelet(integers);
+
+	page->freeze();
+
+	PolymorphicSharedPtr<SerializedObject> original = page->serialize(0);
+	PolymorphicSharedPtr<SerializedObject> current = page->serialize();
+
+	BOOST_CHECK(original->hash() != current->hash());
+
+	boost::shared_ptr<VectorPage> fromOriginal = VectorPage::deserialize(vdm, original);
+	boost::shared_ptr<VectorPage> fromCurrent = VectorPage::deserialize(vdm, current);
+
+	BOOST_CHECK(fromOriginal->getPageId() == page->getPageId());
+	BOOST_REQUIRE_EQUAL(fromOriginal->getPageletTree()->size(), page->getPageletTree()->size());
+
+	for (long k = 0; k < page->getPageletTree()->size(); k++)
+		{
+		BOOST_CHECK(
+			page->getPageletTree()->extractValueIntoFreeStore(k) ==
+				fromOriginal->getPageletTree()->extractValueIntoFreeStore(k)
+			);
+		BOOST_CHECK(
+			page->getPageletTree()->extractValueIntoFreeStore(k) ==
+				fromCurrent->getPageletTree()->extractValueIntoFreeStore(k)
+			);
+		}
+
+	//once read, an old page writes itself out in the current format
+	BOOST_CHECK(fromOriginal->serialize()->hash() == current->hash());
+	}
+
 
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -29,9 +29,11 @@ they're really part of the same module...
 
 """
 
+import hashlib
 import logging
 import os
 import os.path
+import tempfile
 
 import ufora.config.Setup as Setup
 import ufora.FORA.python.ModuleDirectoryStructure as ModuleDirectoryStructure
@@ -39,7 +41,9 @@ import ufora.FORA.python.ErrorFormatting as ErrorFormatting
 import ufora.FORA.python.ForaValue as ForaValue
 import ufora.FORA.python.ParseException as ParseException
 
+import ufora.native
 import ufora.native.FORA as ForaNative
+import ufora.native.Hash as HashNative
 
 
 #some constants we need
@@ -47,6 +51,10 @@ symbol_Call_ = ForaNative.symbol_Call
 symbol_package = ForaNative.makeSymbol("package")
 symbol_member = ForaNative.makeSymbol("member")
 
+#a single parser shared by every import, so that its parse and binding caches
+#carry over from one import to the next
+_moduleParser = ForaNative.ModuleParser()
+
 #exceptions we throw
 class FORAImportException(Exception):
     def __init__(self):
@@ -158,7 +166,7 @@ def importModuleFromMDS(
                 codeLocation.defPoint
                 )
 
-    parser = ForaNative.ModuleParser()
+    parser = _moduleParser
 
     result = parser.bind(importExpr, freeVarDefs, False)
 
@@ -189,7 +197,7 @@ def convertMDSToCreateObjectExpression(mds, path, allowPrivate, name, pathToCode
 
     tree = convertMDSToSourceCodeTree(mds, name)
 
-    parser = ForaNative.ModuleParser()
+    parser = _moduleParser
 
     result = parser.parse(
         tree,
@@ -337,12 +345,22 @@ def initialize(setupObjectToUse = None, reimport = False):
         def pathToCodeDefinitionStrings(path):
             return ["Builtins", os.path.relpath(path, os.path.join(_builtinPath, ".."))]
 
-        _builtinModuleImplVal = importModuleFromPath(
-            _builtinPath,
-            allowPrivate = True,
-            pathToCodeDefinitionStrings = pathToCodeDefinitionStrings
+        snapshotPath = builtinSnapshotPath(
+            setupObjectToUse.config.builtinSnapshotDir,
+            _builtinPath
             )
 
+        _builtinModuleImplVal = loadBuiltinSnapshot(snapshotPath)
+
+        if _builtinModuleImplVal is None:
+            _builtinModuleImplVal = importModuleFromPath(
+                _builtinPath,
+                allowPrivate = True,
+                pathToCodeDefinitionStrings = pathToCodeDefinitionStrings
+                )
+
+            writeBuiltinSnapshot(snapshotPath, _builtinModuleImplVal)
+
     except Exception as e:
         import traceback
         traceback.print_exc()
@@ -352,6 +370,109 @@ def initialize(setupObjectToUse = None, reimport = False):
 
     logging.info("Builtin module hash: %s", hash(_builtinModuleImplVal))
 
+#bump this whenever the bound form of the builtins changes in a way that a hash
+#of the source tree and the native module wouldn't notice
+_builtinSnapshotFormatVersion = 1
+
+def builtinSourceTreeHash(builtinPath):
+    """return a hex digest identifying the builtin source tree at 'builtinPath'
+    together with the native module that binds it"""
+    sha = hashlib.sha1()
+
+    sha.update("format %s\n" % _builtinSnapshotFormatVersion)
+
+    nativeStat = os.stat(ufora.native.__file__)
+    sha.update("native %s %s %s\n" % (
+        ufora.native.__file__,
+        nativeStat.st_size,
+        nativeStat.st_mtime
+        ))
+
+    for root, dirs, files in os.walk(builtinPath):
+        dirs.sort()
+        for fname in sorted(files):
+            if not fname.endswith(".fora"):
+                continue
+
+            path = os.path.join(root, fname)
+
+            with open(path, "rb") as f:
+                data = f.read()
+
+            sha.update("%s %s\n" % (os.path.relpath(path, builtinPath), len(data)))
+            sha.update(data)
+
+    return sha.hexdigest()
+
+def builtinSnapshotPath(snapshotDir, builtinPath):
+    """return the file a snapshot of the builtins at 'builtinPath' lives in, or None
+    if snapshots are disabled"""
+    if not snapshotDir:
+        return None
+
+    return os.path.join(snapshotDir, "builtins_%s.dat" % builtinSourceTreeHash(builtinPath))
+
+def loadBuiltinSnapshot(snapshotPath):
+    """return the bound builtin module stored at 'snapshotPath', or None if there is
+    no usable snapshot there"""
+    if snapshotPath is None or not os.path.isfile(snapshotPath):
+        return None
+
+    try:
+        with open(snapshotPath, "rb") as f:
+            expectedHash = HashNative.Hash.stringToHash(f.readline().strip())
+            data = f.read()
+
+        result = ForaNative.ImplValContainer()
+        result.deserializeEntireObjectGraph(data)
+
+        #workers compare builtin hashes with each other, so a snapshot that doesn't
+        #reproduce exactly the value we bound when writing it is useless
+        if result.hash != expectedHash:
+            logging.warn(
+                "Builtin snapshot %s has hash %s but expected %s. Rebinding builtins.",
+                snapshotPath,
+                result.hash,
+                expectedHash
+                )
+            return None
+
+        logging.info("Loaded builtins from snapshot %s", snapshotPath)
+
+        return result
+    except:
+        logging.warn(
+            "Failed to load builtin snapshot %s. Rebinding builtins.",
+            snapshotPath,
+            exc_info=True
+            )
+        return None
+
+def writeBuiltinSnapshot(snapshotPath, builtinImplVal):
+    """write 'builtinImplVal' to 'snapshotPath'. Failures are logged, not raised,
+    since the snapshot is only an optimization."""
+    if snapshotPath is None:
+        return
+
+    try:
+        snapshotDir = os.path.dirname(snapshotPath)
+
+        if not os.path.isdir(snapshotDir):
+            os.makedirs(snapshotDir)
+
+        data = builtinImplVal.serializeEntireObjectGraph()
+
+        #write to a temporary file and rename it into place so that workers starting
+        #concurrently never see a partial snapshot
+        fd, tempPath = tempfile.mkstemp(dir=snapshotDir, prefix=".builtins_")
+        with os.fdopen(fd, "wb") as f:
+            f.write(str(builtinImplVal.hash) + "\n")
+            f.write(data)
+
+        os.rename(tempPath, snapshotPath)
+    except:
+        logging.warn("Failed to write builtin snapshot %s", snapshotPath, exc_info=True)
+
 def pathToBuiltins():
     return _builtinPath
 
@@ -0,0 +1,78 @@
+#   Copyright 2015 Ufora Inc.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+import shutil
+import tempfile
+import unittest
+import ufora.FORA.python.ModuleImporter as ModuleImporter
+
+class TestModuleImporter(unittest.TestCase):
+    def setUp(self):
+        self.snapshotDir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.snapshotDir)
+
+    def test_builtin_snapshot_roundtrip(self):
+        builtins = ModuleImporter.builtinModuleImplVal()
+
+        snapshotPath = ModuleImporter.builtinSnapshotPath(
+            self.snapshotDir,
+            ModuleImporter.pathToBuiltins()
+            )
+
+        self.assertTrue(ModuleImporter.loadBuiltinSnapshot(snapshotPath) is None)
+
+        ModuleImporter.writeBuiltinSnapshot(snapshotPath, builtins)
+
+        self.assertEqual(os.listdir(self.snapshotDir), [os.path.basename(snapshotPath)])
+
+        loaded = ModuleImporter.loadBuiltinSnapshot(snapshotPath)
+
+        self.assertTrue(loaded is not None)
+        self.assertEqual(loaded.hash, builtins.hash)
+
+    def test_builtin_snapshot_path_tracks_source(self):
+        builtinPath = ModuleImporter.pathToBuiltins()
+
+        self.assertEqual(
+            ModuleImporter.builtinSnapshotPath(self.snapshotDir, builtinPath),
+            ModuleImporter.builtinSnapshotPath(self.snapshotDir, builtinPath)
+            )
+
+        self.assertTrue(ModuleImporter.builtinSnapshotPath("", builtinPath) is None)
+
+        sourceDir = os.path.join(self.snapshotDir, "source")
+        os.makedirs(sourceDir)
+
+        with open(os.path.join(sourceDir, "a.fora"), "wb") as f:
+            f.write("x: 1;")
+
+        hash1 = ModuleImporter.builtinSourceTreeHash(sourceDir)
+
+        with open(os.path.join(sourceDir, "a.fora"), "wb") as f:
+            f.write("x: 2;")
+
+        self.assertNotEqual(hash1, ModuleImporter.builtinSourceTreeHash(sourceDir))
+
+    def test_corrupt_builtin_snapshot_is_ignored(self):
+        snapshotPath = os.path.join(self.snapshotDir, "builtins_corrupt.dat")
+
+        with open(snapshotPath, "wb") as f:
+            f.write(str(ModuleImporter.builtinModuleImplVal().hash) + "\n")
+            f.write("not a serialized object graph")
+
+        self.assertTrue(ModuleImporter.loadBuiltinSnapshot(snapshotPath) is None)
+
@@ -189,6 +189,8 @@ class Converter(object):
                     objectIdToObjectDefinition
                     )
                 )
+        elif isinstance(objectDefinition, TypeDescription.PackedHomogenousData):
+            return self.convertPackedHomogenousData(objectDefinition)
         elif isinstance(objectDefinition, TypeDescription.Unconvertible):
             return self.convertUnconvertibleValue(objectId)
         else:
@@ -258,6 +260,12 @@ class Converter(object):
 
         return self.nativeConverterAdaptor.convertConstant(value)
 
+    def convertPackedHomogenousData(self, objectDefinition):
+        return self.nativeConverterAdaptor.createListOfPrimitivesFromString(
+            base64.b64decode(objectDefinition.dataAsBase64),
+            objectDefinition.dtype
+            )
+
     def _assertContainerDoesNotReferenceItself(self,
                                                containerId,
                                                dependencyGraph,
@@ -456,6 +464,9 @@ class Converter(object):
             self.convertedValues[objectId] = self.convertInstanceMethod(objectId,
                                                                         objectIdToObjectDefinition)
 
+        elif isinstance(objectDefinition, TypeDescription.PackedHomogenousData):
+            self.convertedValues[objectId] = self.convertPackedHomogenousData(objectDefinition)
+
         elif isinstance(objectDefinition, TypeDescription.Unconvertible):
             self.convertedValues[objectId] = Symbol_unconvertible
 
@@ -630,6 +641,12 @@ class Converter(object):
                     return transformer.transformListThatNeedsLoading(len(listItemsAsVector))
                 elif 'listContents' in contents:
                     return transformer.transformList([transform(x) for x in contents['listContents']])
+                elif 'contentsAsBase64Chunks' in contents:
+                    return transformer.transformHomogenousListFromBase64Chunks(
+                        transform(contents['firstElement']),
+                        contents['dtype'],
+                        contents['contentsAsBase64Chunks']
+                        )
                 else:
                     assert 'firstElement' in contents
                     firstElement = contents['firstElement']
@@ -96,6 +96,14 @@ class NativeConverterAdaptor(object):
             self.vdm_
             )
 
+    def createListOfPrimitivesFromString(self, data, dtype):
+        return self.nativeListConverter.createListOfPrimitivesFromString(
+            data,
+            dtype,
+            self.constantConverter.nativeConstantConverter,
+            self.vdm_
+            )
+
     def convertConstant(self, value):
         return self.constantConverter.convert(value)
 
@@ -122,6 +122,18 @@ class Config(object):
         self.workerCoreLogFile = self.getConfigValue("UFORA_WORKER_CORE_LOG_FILE",
                                                      checkEnviron=True)
 
+        # in-process metrics are appended to this file (as json lines) and/or
+        # flushed to statsd every 'metricsExportIntervalSeconds'
+        self.metricsFile = self.getConfigValue("UFORA_METRICS_FILE", checkEnviron=True)
+        self.metricsStatsdHost = self.getConfigValue("UFORA_METRICS_STATSD_HOST",
+                                                     checkEnviron=True)
+        self.metricsStatsdPort = self.getConfigValue("UFORA_METRICS_STATSD_PORT",
+                                                     default="8125",
+                                                     checkEnviron=True)
+        self.metricsExportIntervalSeconds = float(
+            self.getConfigValue("UFORA_METRICS_EXPORT_INTERVAL_SEC", 10.0, checkEnviron=True)
+            )
+
         self.setAllPorts(int(self.getConfigValue("BASE_PORT", 30000)))
 
         # FORA CONFIG
@@ -320,6 +332,12 @@ class Config(object):
                                 checkEnviron=True)
             )
 
+        self.builtinSnapshotDir = expandConfigPath(
+            self.getConfigValue("FORA_BUILTIN_SNAPSHOT_DIR",
+                                default=os.path.join(self.rootDataDir, 'builtin_snapshots'),
+                                checkEnviron=True)
+            )
+
 
     def setLoggingLevel(self, foregroundLevel, backgroundLevel=None):
         if backgroundLevel is not None:
@@ -341,6 +359,22 @@ class Config(object):
         if self.workerCoreLogFile:
             NativeLogging.setFileLogger(self.workerCoreLogFile)
 
+    def configureMetricsExport(self):
+        if not self.metricsFile and not self.metricsStatsdHost:
+            return
+
+        import ufora.native.Metrics as NativeMetrics
+
+        if self.metricsFile:
+            NativeMetrics.appendSnapshotsToFile(self.metricsFile)
+
+        if self.metricsStatsdHost:
+            import ufora.native.Statsd as NativeStatsd
+            NativeStatsd.configure(self.metricsStatsdHost, str(self.metricsStatsdPort))
+            NativeStatsd.installMetricsFlusher("ufora.cumulus")
+
+        NativeMetrics.startPeriodicExport(self.metricsExportIntervalSeconds)
+
     def configureLogging(self, level):
         logging.getLogger().setLevel(level)
         self.setNativeLoggingLevel(level)
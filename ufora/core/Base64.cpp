@@ -0,0 +1,113 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Base64.hpp"
+#include "lassert.hpp"
+
+namespace Ufora {
+
+namespace {
+
+const char* kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+}
+
+Base64Encoder::Base64Encoder(char* output) :
+		mOutput(output),
+		mPendingCount(0)
+	{
+	}
+
+void Base64Encoder::encodeGroup(const uint8_t* group)
+	{
+	uint32_t bits = (uint32_t(group[0]) << 16) | (uint32_t(group[1]) << 8) | group[2];
+
+	mOutput[0] = kAlphabet[(bits >> 18) & 63];
+	mOutput[1] = kAlphabet[(bits >> 12) & 63];
+	mOutput[2] = kAlphabet[(bits >> 6) & 63];
+	mOutput[3] = kAlphabet[bits & 63];
+
+	mOutput += 4;
+	}
+
+void Base64Encoder::append(const uint8_t* data, size_t bytes)
+	{
+	//top up a group left over from the previous call
+	while (mPendingCount && mPendingCount < 3 && bytes)
+		{
+		mPending[mPendingCount++] = *data++;
+		bytes--;
+		}
+
+	if (mPendingCount == 3)
+		{
+		encodeGroup(mPending);
+		mPendingCount = 0;
+		}
+
+	while (bytes >= 3)
+		{
+		encodeGroup(data);
+		data += 3;
+		bytes -= 3;
+		}
+
+	while (bytes)
+		{
+		mPending[mPendingCount++] = *data++;
+		bytes--;
+		}
+	}
+
+char* Base64Encoder::finish()
+	{
+	if (mPendingCount)
+		{
+		lassert(mPendingCount < 3);
+
+		long count = mPendingCount;
+
+		for (long k = count; k < 3; k++)
+			mPending[k] = 0;
+
+		encodeGroup(mPending);
+
+		for (long k = count + 1; k < 4; k++)
+			mOutput[k - 4] = '=';
+
+		mPendingCount = 0;
+		}
+
+	return mOutput;
+	}
+
+std::string Base64Encoder::encode(const std::string& data)
+	{
+	std::string result(encodedSize(data.size()), '\0');
+
+	if (!result.size())
+		return result;
+
+	Base64Encoder encoder(&result[0]);
+
+	encoder.append((const uint8_t*)data.data(), data.size());
+
+	lassert(encoder.finish() == &result[0] + result.size());
+
+	return result;
+	}
+
+}
+
@@ -0,0 +1,67 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+namespace Ufora {
+
+/****
+Base64Encoder
+
+Encodes a stream of bytes as standard (RFC 4648, padded) base64 directly into a
+caller-supplied buffer, so that data scattered across many arrays can be encoded
+in one pass without first being gathered into a contiguous block.
+
+	std::string out(Base64Encoder::encodedSize(totalBytes), '\0');
+	Base64Encoder encoder(&out[0]);
+	encoder.append(first, firstBytes);
+	encoder.append(second, secondBytes);
+	encoder.finish();
+
+The output buffer must hold 'encodedSize' of the total number of bytes appended.
+****/
+
+class Base64Encoder {
+public:
+	explicit Base64Encoder(char* output);
+
+	static size_t encodedSize(size_t rawBytes)
+		{
+		return (rawBytes + 2) / 3 * 4;
+		}
+
+	void append(const uint8_t* data, size_t bytes);
+
+	//flush any partial group with padding. Returns one past the last character written.
+	char* finish();
+
+	static std::string encode(const std::string& data);
+
+private:
+	void encodeGroup(const uint8_t* group);
+
+	char* mOutput;
+
+	uint8_t mPending[3];
+
+	long mPendingCount;
+};
+
+}
+
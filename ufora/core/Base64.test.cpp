@@ -0,0 +1,63 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Base64.hpp"
+#include "UnitTest.hpp"
+
+using Ufora::Base64Encoder;
+
+BOOST_AUTO_TEST_SUITE( test_Base64 )
+
+BOOST_AUTO_TEST_CASE( test_rfc4648_vectors )
+	{
+	BOOST_CHECK_EQUAL(Base64Encoder::encode(""), "");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode("f"), "Zg==");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode("fo"), "Zm8=");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode("foo"), "Zm9v");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode("foob"), "Zm9vYg==");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode("fooba"), "Zm9vYmE=");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode("foobar"), "Zm9vYmFy");
+	BOOST_CHECK_EQUAL(Base64Encoder::encode(std::string("\xff\xfe\x00", 3)), "//4A");
+	}
+
+BOOST_AUTO_TEST_CASE( test_appending_in_pieces_matches_one_shot )
+	{
+	std::string data;
+
+	for (long k = 0; k < 1000; k++)
+		data.push_back((char)(k * 37 + k / 7));
+
+	std::string expected = Base64Encoder::encode(data);
+
+	for (long pieceSize = 1; pieceSize < 10; pieceSize++)
+		{
+		std::string out(Base64Encoder::encodedSize(data.size()), '\0');
+
+		Base64Encoder encoder(&out[0]);
+
+		for (long k = 0; k < data.size(); k += pieceSize)
+			encoder.append(
+				(const uint8_t*)data.data() + k,
+				std::min<long>(pieceSize, data.size() - k)
+				);
+
+		BOOST_CHECK(encoder.finish() == &out[0] + out.size());
+
+		BOOST_CHECK_EQUAL(out, expected);
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
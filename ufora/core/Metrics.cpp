@@ -0,0 +1,453 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Metrics.hpp"
+#include "Clock.hpp"
+#include "Logging.hpp"
+#include "lassert.hpp"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace Ufora {
+namespace metrics {
+
+namespace {
+
+AO_t sNextShard = 0;
+
+__thread long tCurrentShard = -1;
+
+class Registry {
+public:
+	Registry() :
+			mExportIntervalSeconds(0),
+			mExportThreadRunning(false)
+		{
+		}
+
+	template<class T>
+	T& lookup(std::map<std::string, boost::shared_ptr<T> >& metrics, const std::string& name)
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		boost::shared_ptr<T>& metric = metrics[name];
+
+		if (!metric)
+			metric.reset(new T());
+
+		return *metric;
+		}
+
+	Counter& counter(const std::string& name)
+		{
+		return lookup(mCounters, name);
+		}
+
+	Gauge& gauge(const std::string& name)
+		{
+		return lookup(mGauges, name);
+		}
+
+	Histogram& histogram(const std::string& name)
+		{
+		return lookup(mHistograms, name);
+		}
+
+	MetricsSnapshot snapshot()
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		MetricsSnapshot result;
+
+		result.timestamp = curClock();
+
+		for (auto& nameAndCounter: mCounters)
+			result.counters[nameAndCounter.first] = nameAndCounter.second->value();
+
+		for (auto& nameAndGauge: mGauges)
+			result.gauges[nameAndGauge.first] = nameAndGauge.second->value();
+
+		for (auto& nameAndHistogram: mHistograms)
+			result.histograms[nameAndHistogram.first] = nameAndHistogram.second->snapshot();
+
+		return result;
+		}
+
+	void addSnapshotListener(snapshot_listener_type listener)
+		{
+		boost::mutex::scoped_lock lock(mMutex);
+
+		mListeners.push_back(listener);
+		}
+
+	void exportSnapshot()
+		{
+		MetricsSnapshot toExport = snapshot();
+
+		std::vector<snapshot_listener_type> listeners;
+
+			{
+			boost::mutex::scoped_lock lock(mMutex);
+
+			listeners = mListeners;
+			}
+
+		for (auto& listener: listeners)
+			listener(toExport);
+		}
+
+	void startPeriodicExport(double intervalSeconds)
+		{
+		lassert(intervalSeconds > 0);
+
+		boost::mutex::scoped_lock lock(mMutex);
+
+		mExportIntervalSeconds = intervalSeconds;
+
+		if (!mExportThreadRunning)
+			{
+			mExportThreadRunning = true;
+			mExportThread.reset(
+				new boost::thread(boost::bind(&Registry::exportLoop, this))
+				);
+			}
+		}
+
+	void stopPeriodicExport()
+		{
+		boost::shared_ptr<boost::thread> thread;
+
+			{
+			boost::mutex::scoped_lock lock(mMutex);
+
+			if (!mExportThreadRunning)
+				return;
+
+			mExportThreadRunning = false;
+			mExportIntervalChanged.notify_all();
+
+			thread = mExportThread;
+			mExportThread.reset();
+			}
+
+		thread->join();
+		}
+
+private:
+	void exportLoop()
+		{
+		while (true)
+			{
+				{
+				boost::mutex::scoped_lock lock(mMutex);
+
+				mExportIntervalChanged.timed_wait(
+					lock,
+					boost::posix_time::milliseconds(long(mExportIntervalSeconds * 1000))
+					);
+
+				if (!mExportThreadRunning)
+					return;
+				}
+
+			exportSnapshot();
+			}
+		}
+
+	boost::mutex mMutex;
+
+	std::map<std::string, boost::shared_ptr<Counter> > mCounters;
+
+	std::map<std::string, boost::shared_ptr<Gauge> > mGauges;
+
+	std::map<std::string, boost::shared_ptr<Histogram> > mHistograms;
+
+	std::vector<snapshot_listener_type> mListeners;
+
+	double mExportIntervalSeconds;
+
+	bool mExportThreadRunning;
+
+	boost::condition_variable mExportIntervalChanged;
+
+	boost::shared_ptr<boost::thread> mExportThread;
+};
+
+Registry& registry()
+	{
+	static Registry* registry = new Registry();
+
+	return *registry;
+	}
+
+void writeJsonString(std::ostream& stream, const std::string& s)
+	{
+	stream << '"';
+
+	for (auto c: s)
+		{
+		if (c == '"' || c == '\\')
+			stream << '\\';
+		stream << c;
+		}
+
+	stream << '"';
+	}
+
+class SnapshotFileAppender {
+public:
+	SnapshotFileAppender(const std::string& path) :
+			mPath(path)
+		{
+		}
+
+	void operator()(const MetricsSnapshot& snapshot) const
+		{
+		std::ofstream file(mPath.c_str(), std::ios_base::out | std::ios_base::app);
+
+		if (!file)
+			{
+			LOG_WARN << "Couldn't open " << mPath << " to write metrics.";
+			return;
+			}
+
+		file << snapshot.toJson() << "\n";
+		}
+
+private:
+	std::string mPath;
+};
+
+}
+
+long currentShard()
+	{
+	if (tCurrentShard < 0)
+		tCurrentShard = AO_fetch_and_add_full(&sNextShard, 1) % kShardCount;
+
+	return tCurrentShard;
+	}
+
+Counter::Counter()
+	{
+	}
+
+int64_t Counter::value() const
+	{
+	int64_t result = 0;
+
+	for (long k = 0; k < kShardCount; k++)
+		result += mShards[k].value;
+
+	return result;
+	}
+
+const long Histogram::kSubBucketBits;
+
+const long Histogram::kSubBuckets;
+
+const long Histogram::kBucketCount;
+
+Histogram::Shard::Shard() :
+		sum(0)
+	{
+	for (long k = 0; k < kBucketCount; k++)
+		buckets[k] = 0;
+	}
+
+Histogram::Histogram()
+	{
+	}
+
+uint64_t Histogram::bucketLowerBound(long bucket)
+	{
+	if (bucket < kSubBuckets)
+		return bucket;
+
+	long exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+
+	uint64_t subBucket = bucket % kSubBuckets;
+
+	return (kSubBuckets + subBucket) << (exponent - kSubBucketBits);
+	}
+
+uint64_t Histogram::bucketUpperBound(long bucket)
+	{
+	if (bucket + 1 >= kBucketCount)
+		return std::numeric_limits<uint64_t>::max();
+
+	return bucketLowerBound(bucket + 1) - 1;
+	}
+
+HistogramSnapshot Histogram::snapshot() const
+	{
+	HistogramSnapshot result;
+
+	for (long shard = 0; shard < kShardCount; shard++)
+		{
+		result.sum += mShards[shard].sum;
+
+		for (long k = 0; k < kBucketCount; k++)
+			if (mShards[shard].buckets[k])
+				{
+				result.bucketCounts[k] += mShards[shard].buckets[k];
+				result.count += mShards[shard].buckets[k];
+				}
+		}
+
+	return result;
+	}
+
+uint64_t HistogramSnapshot::quantile(double q) const
+	{
+	if (!count)
+		return 0;
+
+	uint64_t rank = std::max<double>(1.0, std::min<double>(count, q * count + 0.5));
+
+	uint64_t seen = 0;
+
+	for (auto& bucketAndCount: bucketCounts)
+		{
+		seen += bucketAndCount.second;
+
+		if (seen >= rank)
+			{
+			long bucket = bucketAndCount.first;
+
+			uint64_t low = Histogram::bucketLowerBound(bucket);
+			uint64_t high = Histogram::bucketUpperBound(bucket);
+
+			return low + (high - low) / 2;
+			}
+		}
+
+	return maxValue();
+	}
+
+uint64_t HistogramSnapshot::maxValue() const
+	{
+	if (!bucketCounts.size())
+		return 0;
+
+	return Histogram::bucketUpperBound(bucketCounts.rbegin()->first);
+	}
+
+std::string MetricsSnapshot::toJson() const
+	{
+	std::ostringstream stream;
+
+	stream << std::setprecision(17);
+
+	stream << "{\"timestamp\":" << timestamp << ",\"counters\":{";
+
+	bool isFirst = true;
+	for (auto& nameAndValue: counters)
+		{
+		stream << (isFirst ? "" : ",");
+		writeJsonString(stream, nameAndValue.first);
+		stream << ":" << nameAndValue.second;
+		isFirst = false;
+		}
+
+	stream << "},\"gauges\":{";
+
+	isFirst = true;
+	for (auto& nameAndValue: gauges)
+		{
+		stream << (isFirst ? "" : ",");
+		writeJsonString(stream, nameAndValue.first);
+		stream << ":" << nameAndValue.second;
+		isFirst = false;
+		}
+
+	stream << "},\"histograms\":{";
+
+	isFirst = true;
+	for (auto& nameAndHistogram: histograms)
+		{
+		const HistogramSnapshot& histogram = nameAndHistogram.second;
+
+		stream << (isFirst ? "" : ",");
+		writeJsonString(stream, nameAndHistogram.first);
+		stream << ":{\"count\":" << histogram.count
+			<< ",\"mean\":" << histogram.mean()
+			<< ",\"p50\":" << histogram.quantile(0.5)
+			<< ",\"p90\":" << histogram.quantile(0.9)
+			<< ",\"p99\":" << histogram.quantile(0.99)
+			<< ",\"max\":" << histogram.maxValue()
+			<< "}";
+		isFirst = false;
+		}
+
+	stream << "}}";
+
+	return stream.str();
+	}
+
+Counter& counter(const std::string& name)
+	{
+	return registry().counter(name);
+	}
+
+Gauge& gauge(const std::string& name)
+	{
+	return registry().gauge(name);
+	}
+
+Histogram& histogram(const std::string& name)
+	{
+	return registry().histogram(name);
+	}
+
+MetricsSnapshot snapshot()
+	{
+	return registry().snapshot();
+	}
+
+void addSnapshotListener(snapshot_listener_type listener)
+	{
+	registry().addSnapshotListener(listener);
+	}
+
+void appendSnapshotsToFile(const std::string& path)
+	{
+	addSnapshotListener(SnapshotFileAppender(path));
+	}
+
+void exportSnapshot()
+	{
+	registry().exportSnapshot();
+	}
+
+void startPeriodicExport(double intervalSeconds)
+	{
+	registry().startPeriodicExport(intervalSeconds);
+	}
+
+void stopPeriodicExport()
+	{
+	registry().stopPeriodicExport();
+	}
+
+}
+}
+
@@ -0,0 +1,252 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include "AtomicOps.hpp"
+#include <boost/function.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Ufora {
+namespace metrics {
+
+/****
+In-process metrics.
+
+Counters, gauges and histograms are registered by name and live for the
+lifetime of the process, so callers on hot paths should look them up once and
+hold on to the reference:
+
+	static Ufora::metrics::Histogram& loadLatency =
+		Ufora::metrics::histogram("pageLoader.diskLoad_us");
+
+	loadLatency.recordSeconds(curClock() - t0);
+
+Counters and histograms are sharded by thread, so recording is a single
+uncontended atomic add. Nothing leaves the process until someone takes a
+snapshot: 'startPeriodicExport' does this on a background thread and hands the
+result to any registered listeners (a file appender, a statsd flusher, ...).
+****/
+
+const static long kShardCount = 16;
+
+//the shard the current thread records into
+long currentShard();
+
+class Counter {
+public:
+	Counter();
+
+	void add(int64_t delta = 1)
+		{
+		AO_fetch_and_add_full(&mShards[currentShard()].value, delta);
+		}
+
+	int64_t value() const;
+
+private:
+	Counter(const Counter&);
+
+	Counter& operator=(const Counter&);
+
+	//pad each shard out to its own cache line
+	class Shard {
+	public:
+		Shard() : value(0)
+			{
+			}
+
+		AO_t value;
+
+		char padding[64 - sizeof(AO_t)];
+	};
+
+	Shard mShards[kShardCount];
+};
+
+class Gauge {
+public:
+	Gauge() : mValue(0)
+		{
+		}
+
+	void set(int64_t value)
+		{
+		AO_store(&mValue, value);
+		}
+
+	void add(int64_t delta)
+		{
+		AO_fetch_and_add_full(&mValue, delta);
+		}
+
+	int64_t value() const
+		{
+		return mValue;
+		}
+
+private:
+	Gauge(const Gauge&);
+
+	Gauge& operator=(const Gauge&);
+
+	AO_t mValue;
+};
+
+class HistogramSnapshot {
+public:
+	HistogramSnapshot() :
+			count(0),
+			sum(0)
+		{
+		}
+
+	uint64_t count;
+
+	uint64_t sum;
+
+	//nonzero buckets, keyed by bucket index
+	std::map<long, uint64_t> bucketCounts;
+
+	//estimate of the value at quantile 'q' (between 0 and 1), or zero if empty
+	uint64_t quantile(double q) const;
+
+	uint64_t maxValue() const;
+
+	double mean() const
+		{
+		return count ? sum / (double)count : 0.0;
+		}
+};
+
+/****
+A log-linear histogram of non-negative integers, in the style of HdrHistogram.
+
+Each power of two is split into 2^kSubBucketBits equal buckets, so every value
+is reported to within 1/8 of its true size while the whole uint64 range fits
+in a fixed array of counters. By convention latencies are recorded in
+microseconds.
+****/
+
+class Histogram {
+public:
+	const static long kSubBucketBits = 3;
+
+	const static long kSubBuckets = 1 << kSubBucketBits;
+
+	const static long kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+	Histogram();
+
+	void record(uint64_t value)
+		{
+		Shard& shard = mShards[currentShard()];
+
+		AO_fetch_and_add_full(&shard.buckets[bucketFor(value)], 1);
+		AO_fetch_and_add_full(&shard.sum, value);
+		}
+
+	void recordSeconds(double seconds)
+		{
+		record(seconds > 0 ? seconds * 1000000.0 : 0);
+		}
+
+	HistogramSnapshot snapshot() const;
+
+	static long bucketFor(uint64_t value)
+		{
+		if (value < kSubBuckets)
+			return value;
+
+		long exponent = 63 - __builtin_clzll(value);
+
+		long subBucket = (value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+
+		return (exponent - kSubBucketBits + 1) * kSubBuckets + subBucket;
+		}
+
+	//smallest value that lands in 'bucket'
+	static uint64_t bucketLowerBound(long bucket);
+
+	//largest value that lands in 'bucket'
+	static uint64_t bucketUpperBound(long bucket);
+
+private:
+	Histogram(const Histogram&);
+
+	Histogram& operator=(const Histogram&);
+
+	class Shard {
+	public:
+		Shard();
+
+		AO_t buckets[kBucketCount];
+
+		AO_t sum;
+	};
+
+	Shard mShards[kShardCount];
+};
+
+class MetricsSnapshot {
+public:
+	MetricsSnapshot() : timestamp(0)
+		{
+		}
+
+	double timestamp;
+
+	std::map<std::string, int64_t> counters;
+
+	std::map<std::string, int64_t> gauges;
+
+	std::map<std::string, HistogramSnapshot> histograms;
+
+	//a single line of JSON. Histograms are summarized as count, mean, p50,
+	//p90, p99 and max.
+	std::string toJson() const;
+};
+
+//look up (or create) the metric with a given name. The returned reference is
+//valid for the lifetime of the process.
+Counter& counter(const std::string& name);
+
+Gauge& gauge(const std::string& name);
+
+Histogram& histogram(const std::string& name);
+
+MetricsSnapshot snapshot();
+
+typedef boost::function1<void, const MetricsSnapshot&> snapshot_listener_type;
+
+void addSnapshotListener(snapshot_listener_type listener);
+
+//append each exported snapshot to 'path' as a line of JSON
+void appendSnapshotsToFile(const std::string& path);
+
+//take a snapshot and hand it to every listener
+void exportSnapshot();
+
+//call 'exportSnapshot' every 'intervalSeconds' on a background thread. Calling
+//again changes the interval.
+void startPeriodicExport(double intervalSeconds);
+
+void stopPeriodicExport();
+
+}
+}
+
@@ -0,0 +1,56 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "../native/module.hpp"
+#include "Metrics.hpp"
+
+#include <boost/python.hpp>
+#include "../native/Registrar.hpp"
+
+class MetricsWrapper :
+	public native::module::Exporter<MetricsWrapper> {
+public:
+	std::string		getModuleName(void)
+		{
+		return "Metrics";
+		}
+
+	static std::string snapshotJson()
+		{
+		return Ufora::metrics::snapshot().toJson();
+		}
+
+	static void appendSnapshotsToFile(std::string path)
+		{
+		Ufora::metrics::appendSnapshotsToFile(path);
+		}
+
+	void exportPythonWrapper()
+		{
+		using namespace boost::python;
+		def("snapshotJson", snapshotJson);
+		def("appendSnapshotsToFile", appendSnapshotsToFile);
+		def("exportSnapshot", Ufora::metrics::exportSnapshot);
+		def("startPeriodicExport", Ufora::metrics::startPeriodicExport);
+		def("stopPeriodicExport", Ufora::metrics::stopPeriodicExport);
+		}
+};
+
+//explicitly instantiating the registration element causes the linker to need
+//this file
+template<>
+char native::module::Exporter<MetricsWrapper>::mEnforceRegistration =
+	native::module::ExportRegistrar<MetricsWrapper>::registerWrapper();
+
@@ -0,0 +1,99 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Metrics.hpp"
+#include "UnitTest.hpp"
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+using namespace Ufora::metrics;
+
+BOOST_AUTO_TEST_SUITE( test_Metrics )
+
+BOOST_AUTO_TEST_CASE( test_histogram_buckets_cover_their_values )
+	{
+	for (uint64_t value = 0; value < 100000; value++)
+		{
+		long bucket = Histogram::bucketFor(value);
+
+		BOOST_REQUIRE(Histogram::bucketLowerBound(bucket) <= value);
+		BOOST_REQUIRE(value <= Histogram::bucketUpperBound(bucket));
+		}
+
+	BOOST_CHECK_EQUAL(
+		Histogram::bucketFor(std::numeric_limits<uint64_t>::max()),
+		Histogram::kBucketCount - 1
+		);
+	}
+
+BOOST_AUTO_TEST_CASE( test_histogram_quantiles )
+	{
+	Histogram& latencies = histogram("test_Metrics.latencies");
+
+	for (long k = 1; k <= 1000; k++)
+		latencies.record(k);
+
+	HistogramSnapshot snapshot = latencies.snapshot();
+
+	BOOST_CHECK_EQUAL(snapshot.count, 1000);
+	BOOST_CHECK_EQUAL(snapshot.sum, 500500);
+
+	//values are only accurate to within a bucket, which is 1/8 of the value
+	BOOST_CHECK_CLOSE(double(snapshot.quantile(0.5)), 500.0, 12.5);
+	BOOST_CHECK_CLOSE(double(snapshot.quantile(0.99)), 990.0, 12.5);
+	BOOST_CHECK(snapshot.maxValue() >= 1000);
+	}
+
+BOOST_AUTO_TEST_CASE( test_counters_across_threads )
+	{
+	Counter& events = counter("test_Metrics.events");
+
+	BOOST_CHECK(&events == &counter("test_Metrics.events"));
+
+	boost::thread_group threads;
+
+	for (long k = 0; k < 8; k++)
+		threads.create_thread([&]() {
+			for (long j = 0; j < 10000; j++)
+				events.add();
+			});
+
+	threads.join_all();
+
+	BOOST_CHECK_EQUAL(events.value(), 80000);
+	BOOST_CHECK_EQUAL(snapshot().counters["test_Metrics.events"], 80000);
+	}
+
+BOOST_AUTO_TEST_CASE( test_snapshot_listeners )
+	{
+	gauge("test_Metrics.gauge").set(7);
+
+	//listeners live forever, so don't let this one refer to the stack
+	boost::shared_ptr<std::vector<MetricsSnapshot> > exported(new std::vector<MetricsSnapshot>());
+
+	addSnapshotListener([exported](const MetricsSnapshot& snapshot) {
+		exported->push_back(snapshot);
+		});
+
+	exportSnapshot();
+
+	BOOST_REQUIRE_EQUAL(exported->size(), 1);
+	BOOST_CHECK_EQUAL((*exported)[0].gauges["test_Metrics.gauge"], 7);
+
+	BOOST_CHECK(snapshot().toJson().find("\"test_Metrics.gauge\":7") != std::string::npos);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,302 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Tracing.hpp"
+#include "AtomicOps.hpp"
+#include "Clock.hpp"
+#include "Logging.hpp"
+#include "threading/SpinlockMutex.hpp"
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace Ufora {
+namespace tracing {
+
+namespace {
+
+//fixed-size ring of spans belonging to a single thread. Only the owning
+//thread writes, but collectSpans and clear may read concurrently, so we guard
+//with a spinlock that is essentially never contended.
+class ThreadSpanBuffer {
+public:
+	ThreadSpanBuffer(long threadIndex, long capacity) :
+			mThreadIndex(threadIndex),
+			mSpans(std::max<long>(capacity, 1)),
+			mNextWrite(0),
+			mSpanCount(0)
+		{
+		}
+
+	void record(const SpanRecord& span)
+		{
+		Ufora::threading::Spinlock lock(mMutex);
+
+		mSpans[mNextWrite] = span;
+		mSpans[mNextWrite].threadIndex = mThreadIndex;
+
+		mNextWrite = (mNextWrite + 1) % mSpans.size();
+
+		if (mSpanCount < mSpans.size())
+			mSpanCount++;
+		}
+
+	void appendTo(std::vector<SpanRecord>& outSpans)
+		{
+		Ufora::threading::Spinlock lock(mMutex);
+
+		long firstIndex = (mNextWrite + mSpans.size() - mSpanCount) % mSpans.size();
+
+		for (long k = 0; k < mSpanCount; k++)
+			outSpans.push_back(mSpans[(firstIndex + k) % mSpans.size()]);
+		}
+
+	void clear()
+		{
+		Ufora::threading::Spinlock lock(mMutex);
+
+		mNextWrite = 0;
+		mSpanCount = 0;
+		}
+
+private:
+	Ufora::threading::SpinlockMutex mMutex;
+
+	long mThreadIndex;
+
+	std::vector<SpanRecord> mSpans;
+
+	long mNextWrite;
+
+	long mSpanCount;
+};
+
+AO_t sTracingEnabled = 0;
+
+AO_t sSpansPerThread = kDefaultSpansPerThread;
+
+boost::mutex sBufferRegistryMutex;
+
+//buffers are never destroyed, since spans recorded on a thread should still
+//be visible after the thread exits
+std::vector<boost::shared_ptr<ThreadSpanBuffer> > sBufferRegistry;
+
+__thread ThreadSpanBuffer* tCurrentThreadBuffer = 0;
+
+__thread hash_type* tCurrentTraceId = 0;
+
+ThreadSpanBuffer* currentThreadBuffer()
+	{
+	if (!tCurrentThreadBuffer)
+		{
+		boost::mutex::scoped_lock lock(sBufferRegistryMutex);
+
+		boost::shared_ptr<ThreadSpanBuffer> buffer(
+			new ThreadSpanBuffer(sBufferRegistry.size(), AO_load(&sSpansPerThread))
+			);
+
+		sBufferRegistry.push_back(buffer);
+
+		tCurrentThreadBuffer = buffer.get();
+		}
+
+	return tCurrentThreadBuffer;
+	}
+
+std::vector<boost::shared_ptr<ThreadSpanBuffer> > allBuffers()
+	{
+	boost::mutex::scoped_lock lock(sBufferRegistryMutex);
+
+	return sBufferRegistry;
+	}
+
+void writeJsonString(std::ostream& stream, const std::string& s)
+	{
+	stream << '"';
+
+	for (long k = 0; k < s.size(); k++)
+		{
+		char c = s[k];
+
+		if (c == '"' || c == '\\')
+			stream << '\\' << c;
+		else
+		if (c == '\n')
+			stream << "\\n";
+		else
+		if ((unsigned char)c < 0x20)
+			stream << ' ';
+		else
+			stream << c;
+		}
+
+	stream << '"';
+	}
+
+bool spanStartsBefore(const SpanRecord& lhs, const SpanRecord& rhs)
+	{
+	return lhs.startTime < rhs.startTime;
+	}
+
+}
+
+void enable(long spansPerThread)
+	{
+	lassert(spansPerThread > 0);
+
+	AO_store(&sSpansPerThread, spansPerThread);
+	AO_store(&sTracingEnabled, 1);
+	}
+
+void disable()
+	{
+	AO_store(&sTracingEnabled, 0);
+	}
+
+bool isEnabled()
+	{
+	return sTracingEnabled;
+	}
+
+hash_type currentTraceId()
+	{
+	if (tCurrentTraceId)
+		return *tCurrentTraceId;
+
+	return hash_type();
+	}
+
+void recordSpan(const char* name, hash_type tag, double startTime, double endTime)
+	{
+	SpanRecord span;
+
+	span.name = name;
+	span.traceId = currentTraceId();
+	span.tag = tag;
+	span.startTime = startTime;
+	span.endTime = endTime;
+
+	currentThreadBuffer()->record(span);
+	}
+
+std::vector<SpanRecord> collectSpans()
+	{
+	std::vector<SpanRecord> result;
+
+	std::vector<boost::shared_ptr<ThreadSpanBuffer> > buffers = allBuffers();
+
+	for (long k = 0; k < buffers.size(); k++)
+		buffers[k]->appendTo(result);
+
+	std::stable_sort(result.begin(), result.end(), spanStartsBefore);
+
+	return result;
+	}
+
+void clear()
+	{
+	std::vector<boost::shared_ptr<ThreadSpanBuffer> > buffers = allBuffers();
+
+	for (long k = 0; k < buffers.size(); k++)
+		buffers[k]->clear();
+	}
+
+std::string spansToChromeTraceJson(
+				const std::vector<SpanRecord>& spans,
+				const std::string& processName
+				)
+	{
+	std::ostringstream stream;
+
+	stream.precision(17);
+
+	long pid = getpid();
+
+	stream << "{\"traceEvents\":[\n";
+
+	stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+		<< ",\"args\":{\"name\":";
+	writeJsonString(stream, processName);
+	stream << "}}";
+
+	for (long k = 0; k < spans.size(); k++)
+		{
+		const SpanRecord& span = spans[k];
+
+		stream << ",\n{\"name\":";
+		writeJsonString(stream, span.name ? span.name : "");
+		stream << ",\"cat\":\"ufora\",\"ph\":\"X\""
+			<< ",\"ts\":" << span.startTime * 1000000.0
+			<< ",\"dur\":" << (span.endTime - span.startTime) * 1000000.0
+			<< ",\"pid\":" << pid
+			<< ",\"tid\":" << span.threadIndex
+			<< ",\"args\":{\"trace\":\"" << hashToString(span.traceId) << "\""
+			<< ",\"tag\":\"" << hashToString(span.tag) << "\"}}";
+		}
+
+	stream << "\n]}\n";
+
+	return stream.str();
+	}
+
+void writeChromeTraceFile(const std::string& path, const std::string& processName)
+	{
+	std::vector<SpanRecord> spans = collectSpans();
+
+	std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+	if (!file)
+		{
+		LOG_ERROR << "Couldn't open " << path << " to write trace data.";
+		return;
+		}
+
+	file << spansToChromeTraceJson(spans, processName);
+
+	LOG_INFO << "Wrote " << spans.size() << " trace spans to " << path;
+	}
+
+ScopedTraceContext::ScopedTraceContext(hash_type traceId) :
+		mTraceId(traceId),
+		mOriginal(tCurrentTraceId)
+	{
+	tCurrentTraceId = &mTraceId;
+	}
+
+ScopedTraceContext::~ScopedTraceContext()
+	{
+	tCurrentTraceId = mOriginal;
+	}
+
+ScopedSpan::ScopedSpan(const char* name, hash_type tag) :
+		mName(name),
+		mTag(tag),
+		mStartTime(sTracingEnabled ? curClock() : -1.0)
+	{
+	}
+
+ScopedSpan::~ScopedSpan()
+	{
+	if (mStartTime >= 0.0)
+		recordSpan(mName, mTag, mStartTime, curClock());
+	}
+
+}
+}
+
@@ -0,0 +1,142 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include "math/Hash.hpp"
+#include <string>
+#include <vector>
+
+namespace Ufora {
+namespace tracing {
+
+/****
+Lightweight span tracing.
+
+A span records a named interval of work on one thread, tagged with the trace
+it belongs to (usually the root computation it was done for) and an optional
+tag identifying the specific object involved (a computation, page, ...).
+
+Spans are written into a fixed-size ring buffer owned by the recording thread,
+so recording never allocates or contends with other threads. When a buffer
+fills, its oldest spans are overwritten. Tracing is off by default, in which
+case a ScopedSpan costs a single flag load.
+
+The current trace id is thread-local and set with ScopedTraceContext. Worker
+to worker messages carry it, so spans recorded on different machines on behalf
+of the same root computation share a trace id and can be stitched together.
+
+Usage:
+
+	Ufora::tracing::enable();
+
+		{
+		ScopedTraceContext trace(rootComputationGuid);
+		ScopedSpan span("compute", computationGuid);
+		...
+		}
+
+	Ufora::tracing::writeChromeTraceFile("/tmp/trace.json", "worker 1");
+
+The output file can be loaded into chrome://tracing.
+****/
+
+class SpanRecord {
+public:
+	SpanRecord() :
+			name(0),
+			startTime(0),
+			endTime(0),
+			threadIndex(0)
+		{
+		}
+
+	const char* name; //must point to static storage
+
+	hash_type traceId;
+
+	hash_type tag;
+
+	double startTime;
+
+	double endTime;
+
+	long threadIndex;
+};
+
+const static long kDefaultSpansPerThread = 16 * 1024;
+
+void enable(long spansPerThread = kDefaultSpansPerThread);
+
+void disable();
+
+bool isEnabled();
+
+//the trace id active on the current thread, or hash_type() if none
+hash_type currentTraceId();
+
+//copy out every span currently held by any thread's buffer, ordered by start time
+std::vector<SpanRecord> collectSpans();
+
+//discard all recorded spans
+void clear();
+
+//write all recorded spans as a Chrome trace-event JSON file
+void writeChromeTraceFile(const std::string& path, const std::string& processName);
+
+std::string spansToChromeTraceJson(
+				const std::vector<SpanRecord>& spans,
+				const std::string& processName
+				);
+
+void recordSpan(const char* name, hash_type tag, double startTime, double endTime);
+
+class ScopedTraceContext {
+public:
+	ScopedTraceContext(hash_type traceId);
+
+	~ScopedTraceContext();
+
+private:
+	ScopedTraceContext(const ScopedTraceContext&);
+
+	ScopedTraceContext& operator=(const ScopedTraceContext&);
+
+	hash_type mTraceId;
+
+	hash_type* mOriginal;
+};
+
+class ScopedSpan {
+public:
+	ScopedSpan(const char* name, hash_type tag = hash_type());
+
+	~ScopedSpan();
+
+private:
+	ScopedSpan(const ScopedSpan&);
+
+	ScopedSpan& operator=(const ScopedSpan&);
+
+	const char* mName;
+
+	hash_type mTag;
+
+	double mStartTime;
+};
+
+}
+}
+
@@ -0,0 +1,62 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "../native/module.hpp"
+#include "Tracing.hpp"
+
+#include <boost/python.hpp>
+#include "../native/Registrar.hpp"
+
+class TracingWrapper :
+	public native::module::Exporter<TracingWrapper> {
+public:
+	std::string		getModuleName(void)
+		{
+		return "Tracing";
+		}
+
+	static void enable(long spansPerThread)
+		{
+		Ufora::tracing::enable(spansPerThread);
+		}
+
+	static void enableWithDefaults()
+		{
+		Ufora::tracing::enable();
+		}
+
+	static void writeChromeTraceFile(std::string path, std::string processName)
+		{
+		Ufora::tracing::writeChromeTraceFile(path, processName);
+		}
+
+	void exportPythonWrapper()
+		{
+		using namespace boost::python;
+		def("enable", enable);
+		def("enable", enableWithDefaults);
+		def("disable", Ufora::tracing::disable);
+		def("isEnabled", Ufora::tracing::isEnabled);
+		def("clear", Ufora::tracing::clear);
+		def("writeChromeTraceFile", writeChromeTraceFile);
+		}
+};
+
+//explicitly instantiating the registration element causes the linker to need
+//this file
+template<>
+char native::module::Exporter<TracingWrapper>::mEnforceRegistration =
+	native::module::ExportRegistrar<TracingWrapper>::registerWrapper();
+
@@ -0,0 +1,116 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "Tracing.hpp"
+#include "UnitTest.hpp"
+#include <boost/thread.hpp>
+
+using namespace Ufora::tracing;
+
+namespace {
+
+class TracingEnabledFixture {
+public:
+	TracingEnabledFixture()
+		{
+		enable(4);
+		clear();
+		}
+
+	~TracingEnabledFixture()
+		{
+		disable();
+		clear();
+		}
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_Tracing )
+
+BOOST_AUTO_TEST_CASE( test_disabled_tracing_records_nothing )
+	{
+	disable();
+	clear();
+
+		{
+		ScopedSpan span("shouldNotAppear");
+		}
+
+	BOOST_CHECK_EQUAL(collectSpans().size(), 0);
+	}
+
+BOOST_FIXTURE_TEST_CASE( test_spans_carry_trace_ids, TracingEnabledFixture )
+	{
+	hash_type traceId = hash_type(1);
+	hash_type tag = hash_type(2);
+
+	BOOST_CHECK(currentTraceId() == hash_type());
+
+		{
+		ScopedTraceContext context(traceId);
+
+		BOOST_CHECK(currentTraceId() == traceId);
+
+			{
+			ScopedSpan span("inner", tag);
+			}
+		}
+
+	BOOST_CHECK(currentTraceId() == hash_type());
+
+	std::vector<SpanRecord> spans = collectSpans();
+
+	BOOST_REQUIRE_EQUAL(spans.size(), 1);
+	BOOST_CHECK_EQUAL(std::string(spans[0].name), "inner");
+	BOOST_CHECK(spans[0].traceId == traceId);
+	BOOST_CHECK(spans[0].tag == tag);
+	BOOST_CHECK(spans[0].endTime >= spans[0].startTime);
+	}
+
+BOOST_FIXTURE_TEST_CASE( test_ring_buffer_overwrites_oldest, TracingEnabledFixture )
+	{
+	//the buffer for this thread may already exist with a larger capacity, so
+	//record enough spans to wrap a fresh buffer on a new thread
+	boost::thread recorder([]() {
+		for (long k = 0; k < 10; k++)
+			recordSpan("span", hash_type(k), k, k + 0.5);
+		});
+
+	recorder.join();
+
+	std::vector<SpanRecord> spans = collectSpans();
+
+	BOOST_REQUIRE_EQUAL(spans.size(), 4);
+
+	for (long k = 0; k < 4; k++)
+		BOOST_CHECK(spans[k].tag == hash_type(6 + k));
+	}
+
+BOOST_FIXTURE_TEST_CASE( test_chrome_trace_json, TracingEnabledFixture )
+	{
+		{
+		ScopedSpan span("a \"quoted\" span");
+		}
+
+	std::string json = spansToChromeTraceJson(collectSpans(), "worker");
+
+	BOOST_CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+	BOOST_CHECK(json.find("a \\\"quoted\\\" span") != std::string::npos);
+	BOOST_CHECK(json.find("\"process_name\"") != std::string::npos);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
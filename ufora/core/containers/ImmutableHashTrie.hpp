@@ -0,0 +1,429 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "../math/Hash.hpp"
+#include "../math/Nullable.hpp"
+#include "../lassert.hpp"
+#include "../AtomicOps.hpp"
+#include "../RefcountingPtr.hppml"
+
+/**********
+ImmutableHashTrie
+
+A persistent hash array mapped trie. Each level consumes five bits of the
+key's hash and holds up to 32 slots, compressed by a pair of bitmaps: a slot
+holds either a single key/value pair or a child trie. Updates copy the path
+from the root to the modified slot and share everything else, so insertion,
+removal and lookup all touch O(log32 n) nodes and never compare keys for
+ordering.
+
+Once all 160 bits of hash_type are used up, colliding keys live in a flat
+list at the bottom.
+
+Unlike ImmutableTreeMap, there is no ordering - 'foreach' visits pairs in
+an arbitrary (but deterministic) order. Keys are hashed with 'hasher_type', which defaults to
+hashValue(). Types that already carry a hash (e.g. CSTValue) should supply
+a hasher that returns it directly.
+**********/
+
+template<class TKey>
+class ImmutableHashTrieDefaultHasher {
+public:
+	hash_type operator()(const TKey& in) const
+		{
+		return hashValue(in);
+		}
+};
+
+template<class TKey, class TValue>
+class ImmutableHashTrieNode {
+public:
+	typedef std::pair<TKey, TValue> pair_type;
+
+	typedef RefcountingPtr<ImmutableHashTrieNode<TKey, TValue> > node_ptr;
+
+	class Entry {
+	public:
+		Entry(const hash_type& inHash, const pair_type& inPair) :
+				hash(inHash),
+				value(inPair)
+			{
+			}
+
+		bool matches(const hash_type& inHash, const TKey& inKey) const
+			{
+			return hash == inHash && value.first == inKey;
+			}
+
+		hash_type hash;
+
+		pair_type value;
+	};
+
+	ImmutableHashTrieNode() :
+			mEntryBitmap(0),
+			mChildBitmap(0),
+			mRefcount(0)
+		{
+		}
+
+	ImmutableHashTrieNode(const ImmutableHashTrieNode& in) :
+			mEntryBitmap(in.mEntryBitmap),
+			mChildBitmap(in.mChildBitmap),
+			mEntries(in.mEntries),
+			mChildren(in.mChildren),
+			mRefcount(0)
+		{
+		}
+
+	void incrementRefcount()
+		{
+		AO_fetch_and_add_full(&mRefcount, 1);
+		}
+
+	void decrementRefcount()
+		{
+		if (AO_fetch_and_add_full(&mRefcount, -1) == 1)
+			delete this;
+		}
+
+	bool isEmpty() const
+		{
+		return mEntries.size() == 0 && mChildren.size() == 0;
+		}
+
+	//slots with a key/value pair stored directly in this node
+	uint32_t mEntryBitmap;
+
+	//slots with a child trie
+	uint32_t mChildBitmap;
+
+	//populated slots, in slot order. Nodes at the bottom of the trie ignore
+	//the bitmaps and keep an unordered list of colliding entries.
+	std::vector<Entry> mEntries;
+
+	std::vector<node_ptr> mChildren;
+
+private:
+	AO_t mRefcount;
+};
+
+template<class TKey, class TValue, class hasher_type = ImmutableHashTrieDefaultHasher<TKey> >
+class ImmutableHashTrie {
+	typedef ImmutableHashTrieNode<TKey, TValue> Node;
+
+	typedef typename Node::Entry Entry;
+
+	typedef typename Node::node_ptr node_ptr;
+
+public:
+	typedef std::pair<TKey, TValue> pair_type;
+
+	const static int32_t kBitsPerLevel = 5;
+
+	const static int32_t kMaxDepth = (sizeof(hash_type) * 8) / kBitsPerLevel;
+
+	ImmutableHashTrie() :
+			mSize(0)
+		{
+		}
+
+	size_t size() const
+		{
+		return mSize;
+		}
+
+	Nullable<const TValue&> operator[](const TKey& inKey) const
+		{
+		const pair_type* p = find(mRoot, hasher_type()(inKey), inKey);
+
+		if (!p)
+			return null();
+
+		return Nullable<const TValue&>(p->second);
+		}
+
+	bool contains(const TKey& inKey) const
+		{
+		return find(mRoot, hasher_type()(inKey), inKey) != 0;
+		}
+
+	//add a pair, replacing any existing value for the key
+	ImmutableHashTrie operator+(const pair_type& inPair) const
+		{
+		bool added = false;
+
+		node_ptr newRoot =
+			inserted(mRoot, Entry(hasher_type()(inPair.first), inPair), 0, added);
+
+		return ImmutableHashTrie(newRoot, mSize + (added ? 1 : 0));
+		}
+
+	ImmutableHashTrie operator-(const TKey& inKey) const
+		{
+		bool removed = false;
+
+		node_ptr newRoot = erased(mRoot, hasher_type()(inKey), inKey, 0, removed);
+
+		if (!removed)
+			return *this;
+
+		return ImmutableHashTrie(newRoot, mSize - 1);
+		}
+
+	//visit every pair, in no particular order
+	template<class f_type>
+	void foreach(const f_type& f) const
+		{
+		if (!mRoot.isEmpty())
+			visit(*mRoot, f);
+		}
+
+	//which of the 32 slots 'inHash' falls into at 'depth'
+	static int32_t slotFor(const hash_type& inHash, int32_t depth)
+		{
+		int32_t bit = depth * kBitsPerLevel;
+		int32_t word = bit / 32;
+		int32_t shift = bit % 32;
+
+		uint32_t value = inHash[word] >> shift;
+
+		if (shift + kBitsPerLevel > 32 && (word + 1) * 4 < sizeof(hash_type))
+			value |= inHash[word + 1] << (32 - shift);
+
+		return value & ((1 << kBitsPerLevel) - 1);
+		}
+
+private:
+	ImmutableHashTrie(const node_ptr& inRoot, size_t inSize) :
+			mRoot(inRoot),
+			mSize(inSize)
+		{
+		}
+
+	static int32_t indexOf(uint32_t bitmap, int32_t slot)
+		{
+		return __builtin_popcount(bitmap & ((uint32_t(1) << slot) - 1));
+		}
+
+	static const pair_type* find(const node_ptr& root, const hash_type& inHash, const TKey& inKey)
+		{
+		const Node* node = root.ptr();
+
+		for (int32_t depth = 0; node; depth++)
+			{
+			if (depth >= kMaxDepth)
+				{
+				for (long k = 0; k < node->mEntries.size(); k++)
+					if (node->mEntries[k].matches(inHash, inKey))
+						return &node->mEntries[k].value;
+				return 0;
+				}
+
+			int32_t slot = slotFor(inHash, depth);
+			uint32_t bit = uint32_t(1) << slot;
+
+			if (node->mEntryBitmap & bit)
+				{
+				const Entry& entry = node->mEntries[indexOf(node->mEntryBitmap, slot)];
+
+				return entry.matches(inHash, inKey) ? &entry.value : 0;
+				}
+
+			if (!(node->mChildBitmap & bit))
+				return 0;
+
+			node = node->mChildren[indexOf(node->mChildBitmap, slot)].ptr();
+			}
+
+		return 0;
+		}
+
+	static node_ptr inserted(const node_ptr& node, const Entry& entry, int32_t depth, bool& outAdded)
+		{
+		node_ptr tr(node.isEmpty() ? new Node() : new Node(*node));
+
+		if (depth >= kMaxDepth)
+			{
+			for (long k = 0; k < tr->mEntries.size(); k++)
+				if (tr->mEntries[k].matches(entry.hash, entry.value.first))
+					{
+					tr->mEntries[k] = entry;
+					return tr;
+					}
+
+			tr->mEntries.push_back(entry);
+			outAdded = true;
+			return tr;
+			}
+
+		int32_t slot = slotFor(entry.hash, depth);
+		uint32_t bit = uint32_t(1) << slot;
+
+		if (tr->mEntryBitmap & bit)
+			{
+			int32_t index = indexOf(tr->mEntryBitmap, slot);
+
+			if (tr->mEntries[index].matches(entry.hash, entry.value.first))
+				{
+				tr->mEntries[index] = entry;
+				return tr;
+				}
+
+			//two different keys want this slot - push both of them down a level
+			bool ignored = false;
+			node_ptr child =
+				inserted(
+					inserted(node_ptr(), tr->mEntries[index], depth + 1, ignored),
+					entry,
+					depth + 1,
+					outAdded
+					);
+
+			tr->mEntries.erase(tr->mEntries.begin() + index);
+			tr->mEntryBitmap &= ~bit;
+
+			tr->mChildren.insert(
+				tr->mChildren.begin() + indexOf(tr->mChildBitmap, slot),
+				child
+				);
+			tr->mChildBitmap |= bit;
+
+			return tr;
+			}
+
+		if (tr->mChildBitmap & bit)
+			{
+			node_ptr& child = tr->mChildren[indexOf(tr->mChildBitmap, slot)];
+
+			child = inserted(child, entry, depth + 1, outAdded);
+
+			return tr;
+			}
+
+		tr->mEntries.insert(tr->mEntries.begin() + indexOf(tr->mEntryBitmap, slot), entry);
+		tr->mEntryBitmap |= bit;
+		outAdded = true;
+
+		return tr;
+		}
+
+	static node_ptr erased(
+				const node_ptr& node,
+				const hash_type& inHash,
+				const TKey& inKey,
+				int32_t depth,
+				bool& outRemoved
+				)
+		{
+		if (node.isEmpty())
+			return node;
+
+		if (depth >= kMaxDepth)
+			{
+			for (long k = 0; k < node->mEntries.size(); k++)
+				if (node->mEntries[k].matches(inHash, inKey))
+					{
+					outRemoved = true;
+
+					if (node->mEntries.size() == 1)
+						return node_ptr();
+
+					node_ptr tr(new Node(*node));
+					tr->mEntries.erase(tr->mEntries.begin() + k);
+					return tr;
+					}
+
+			return node;
+			}
+
+		int32_t slot = slotFor(inHash, depth);
+		uint32_t bit = uint32_t(1) << slot;
+
+		if (node->mEntryBitmap & bit)
+			{
+			int32_t index = indexOf(node->mEntryBitmap, slot);
+
+			if (!node->mEntries[index].matches(inHash, inKey))
+				return node;
+
+			outRemoved = true;
+
+			node_ptr tr(new Node(*node));
+			tr->mEntries.erase(tr->mEntries.begin() + index);
+			tr->mEntryBitmap &= ~bit;
+
+			if (tr->isEmpty())
+				return node_ptr();
+
+			return tr;
+			}
+
+		if (!(node->mChildBitmap & bit))
+			return node;
+
+		int32_t childIndex = indexOf(node->mChildBitmap, slot);
+
+		node_ptr newChild = erased(node->mChildren[childIndex], inHash, inKey, depth + 1, outRemoved);
+
+		if (!outRemoved)
+			return node;
+
+		node_ptr tr(new Node(*node));
+
+		if (!newChild.isEmpty() && (newChild->mChildren.size() || newChild->mEntries.size() > 1))
+			{
+			tr->mChildren[childIndex] = newChild;
+			return tr;
+			}
+
+		tr->mChildren.erase(tr->mChildren.begin() + childIndex);
+		tr->mChildBitmap &= ~bit;
+
+		//a child left holding a single pair collapses back into this node
+		if (!newChild.isEmpty())
+			{
+			tr->mEntries.insert(
+				tr->mEntries.begin() + indexOf(tr->mEntryBitmap, slot),
+				newChild->mEntries[0]
+				);
+			tr->mEntryBitmap |= bit;
+			}
+
+		if (tr->isEmpty())
+			return node_ptr();
+
+		return tr;
+		}
+
+	template<class f_type>
+	static void visit(const Node& node, const f_type& f)
+		{
+		for (long k = 0; k < node.mEntries.size(); k++)
+			f(node.mEntries[k].value);
+
+		for (long k = 0; k < node.mChildren.size(); k++)
+			visit(*node.mChildren[k], f);
+		}
+
+	node_ptr mRoot;
+
+	size_t mSize;
+};
+
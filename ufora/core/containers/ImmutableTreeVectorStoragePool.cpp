@@ -0,0 +1,140 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "ImmutableTreeVectorStoragePool.hpp"
+#include <boost/thread/tss.hpp>
+#include <stdlib.h>
+
+namespace {
+
+class FreeBlock {
+public:
+	FreeBlock* mNext;
+};
+
+class ThreadCache {
+public:
+	ThreadCache()
+		{
+		for (long k = 0; k < ImmutableTreeVectorStoragePool::kSizeClassCount; k++)
+			{
+			mFreeBlocks[k] = 0;
+			mFreeBlockCount[k] = 0;
+			}
+		}
+
+	~ThreadCache()
+		{
+		for (long k = 0; k < ImmutableTreeVectorStoragePool::kSizeClassCount; k++)
+			while (mFreeBlocks[k])
+				{
+				FreeBlock* block = mFreeBlocks[k];
+				mFreeBlocks[k] = block->mNext;
+				::free(block);
+				}
+		}
+
+	FreeBlock* mFreeBlocks[ImmutableTreeVectorStoragePool::kSizeClassCount];
+
+	size_t mFreeBlockCount[ImmutableTreeVectorStoragePool::kSizeClassCount];
+};
+
+//marks a thread whose cache has already been torn down. Anything released
+//during the rest of thread exit goes straight back to malloc.
+ThreadCache* const kExitedThreadCache = (ThreadCache*)1;
+
+__thread ThreadCache* tThreadCache = 0;
+
+void releaseThreadCache(ThreadCache* cache)
+	{
+	tThreadCache = kExitedThreadCache;
+	delete cache;
+	}
+
+boost::thread_specific_ptr<ThreadCache>& threadCacheOwner()
+	{
+	static boost::thread_specific_ptr<ThreadCache> owner(&releaseThreadCache);
+
+	return owner;
+	}
+
+ThreadCache* threadCache()
+	{
+	if (!tThreadCache)
+		{
+		tThreadCache = new ThreadCache();
+		threadCacheOwner().reset(tThreadCache);
+		}
+
+	if (tThreadCache == kExitedThreadCache)
+		return 0;
+
+	return tThreadCache;
+	}
+
+}
+
+const int32_t ImmutableTreeVectorStoragePool::kSizeClassCount;
+
+const size_t ImmutableTreeVectorStoragePool::kSmallestBlockBytes;
+
+const size_t ImmutableTreeVectorStoragePool::kCachedBytesPerSizeClass;
+
+void* ImmutableTreeVectorStoragePool::allocate(int32_t sizeClass)
+	{
+	ThreadCache* cache = threadCache();
+
+	if (cache && cache->mFreeBlocks[sizeClass])
+		{
+		FreeBlock* block = cache->mFreeBlocks[sizeClass];
+		cache->mFreeBlocks[sizeClass] = block->mNext;
+		cache->mFreeBlockCount[sizeClass]--;
+		return block;
+		}
+
+	return malloc(bytesForSizeClass(sizeClass));
+	}
+
+void ImmutableTreeVectorStoragePool::free(void* block, int32_t sizeClass)
+	{
+	ThreadCache* cache = threadCache();
+
+	if (!cache || cache->mFreeBlockCount[sizeClass] * bytesForSizeClass(sizeClass) >=
+													kCachedBytesPerSizeClass)
+		{
+		::free(block);
+		return;
+		}
+
+	FreeBlock* freeBlock = (FreeBlock*)block;
+	freeBlock->mNext = cache->mFreeBlocks[sizeClass];
+	cache->mFreeBlocks[sizeClass] = freeBlock;
+	cache->mFreeBlockCount[sizeClass]++;
+	}
+
+size_t ImmutableTreeVectorStoragePool::cachedBlockCount()
+	{
+	ThreadCache* cache = threadCache();
+
+	if (!cache)
+		return 0;
+
+	size_t tr = 0;
+	for (long k = 0; k < kSizeClassCount; k++)
+		tr += cache->mFreeBlockCount[k];
+
+	return tr;
+	}
+
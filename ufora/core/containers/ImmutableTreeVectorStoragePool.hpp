@@ -0,0 +1,71 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/***********
+ImmutableTreeVectorStoragePool
+
+Recycles the blocks backing ImmutableTreeVectorStorage. Blocks come in
+power-of-two size classes from 64 bytes to 8k and are cached in per-thread
+free lists, so building and dropping small vectors (which is most of what
+CPPML message construction and the compiler do) doesn't round-trip through
+malloc. Larger blocks go straight to malloc.
+
+A block may be released on a different thread than the one that allocated
+it - it simply joins the releasing thread's free list.
+************/
+
+class ImmutableTreeVectorStoragePool {
+public:
+	const static int32_t kSizeClassCount = 8;
+
+	const static size_t kSmallestBlockBytes = 64;
+
+	//each thread holds at most this many bytes of free blocks per size class
+	const static size_t kCachedBytesPerSizeClass = 32 * 1024;
+
+	//returns the smallest size class holding 'bytes', or -1 if the block should
+	//come from malloc directly
+	static int32_t sizeClassFor(size_t bytes)
+		{
+		int32_t sizeClass = 0;
+		size_t blockBytes = kSmallestBlockBytes;
+
+		while (blockBytes < bytes && sizeClass < kSizeClassCount)
+			{
+			blockBytes *= 2;
+			sizeClass++;
+			}
+
+		return sizeClass < kSizeClassCount ? sizeClass : -1;
+		}
+
+	static size_t bytesForSizeClass(int32_t sizeClass)
+		{
+		return kSmallestBlockBytes << sizeClass;
+		}
+
+	static void* allocate(int32_t sizeClass);
+
+	static void free(void* block, int32_t sizeClass);
+
+	//total number of blocks sitting in the calling thread's free lists
+	static size_t cachedBlockCount();
+};
+
@@ -0,0 +1,195 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include "../math/Hash.hpp"
+
+/****
+HashConsTable
+
+A map from hash_type to immortal objects, tuned for hash-consing, where almost
+every call finds an object that already exists.
+
+Lookups take no locks. The table uses open addressing with linear probing. A
+slot's key is written before its value pointer is published (with release
+semantics), so a reader that sees a non-null value also sees its key.
+Insertions take a recursive mutex, since constructing a new object may
+recursively intern other objects in the same table.
+
+When the table passes half full, we build a table twice the size and publish
+it. Readers may still be probing the old table, so we never free it. Old tables
+add up to less than the live one, and the values themselves are never freed,
+so nothing else needs reclaiming.
+****/
+
+template<class value_type>
+class HashConsTable {
+public:
+	HashConsTable() :
+			mSize(0)
+		{
+		boost::shared_ptr<Table> table(new Table(kInitialSlotCount));
+
+		mTables.push_back(table);
+		mCurrentTable.store(table.get(), std::memory_order_release);
+		}
+
+	value_type* find(const hash_type& hash) const
+		{
+		return mCurrentTable.load(std::memory_order_acquire)->find(hash);
+		}
+
+	//return the value for 'hash', calling 'factory' to create it if it's missing
+	template<class factory_type>
+	value_type* findOrCreate(const hash_type& hash, const factory_type& factory)
+		{
+		value_type* existing = find(hash);
+
+		if (existing)
+			return existing;
+
+		boost::recursive_mutex::scoped_lock lock(mWriteMutex);
+
+		existing = find(hash);
+
+		if (existing)
+			return existing;
+
+		value_type* created = factory();
+
+		//'factory' may have grown the table, so look it up again
+		Table* table = mCurrentTable.load(std::memory_order_relaxed);
+
+		if ((mSize + 1) * 2 > table->slotCount())
+			table = grow_(table);
+
+		table->insert(hash, created);
+		mSize++;
+
+		return created;
+		}
+
+	size_t size() const
+		{
+		boost::recursive_mutex::scoped_lock lock(mWriteMutex);
+
+		return mSize;
+		}
+
+private:
+	const static size_t kInitialSlotCount = 64;
+
+	class Table {
+	public:
+		Table(size_t slotCount) :
+				mSlots(slotCount),
+				mMask(slotCount - 1)
+			{
+			}
+
+		size_t slotCount() const
+			{
+			return mSlots.size();
+			}
+
+		value_type* find(const hash_type& hash) const
+			{
+			for (size_t index = slotFor(hash); ; index = (index + 1) & mMask)
+				{
+				value_type* value = mSlots[index].value.load(std::memory_order_acquire);
+
+				if (!value)
+					return 0;
+
+				if (mSlots[index].key == hash)
+					return value;
+				}
+			}
+
+		//caller must hold the write lock and ensure there is a free slot
+		void insert(const hash_type& hash, value_type* value)
+			{
+			size_t index = slotFor(hash);
+
+			while (mSlots[index].value.load(std::memory_order_relaxed))
+				index = (index + 1) & mMask;
+
+			mSlots[index].key = hash;
+			mSlots[index].value.store(value, std::memory_order_release);
+			}
+
+		void copyInto(Table& other) const
+			{
+			for (const auto& slot: mSlots)
+				{
+				value_type* value = slot.value.load(std::memory_order_relaxed);
+
+				if (value)
+					other.insert(slot.key, value);
+				}
+			}
+
+	private:
+		size_t slotFor(const hash_type& hash) const
+			{
+			//the low bits of hash[0] are often used to pick a stripe, so use
+			//another word to pick the slot
+			return hash[1] & mMask;
+			}
+
+		class Slot {
+		public:
+			Slot() : value(nullptr)
+				{
+				}
+
+			hash_type key;
+
+			std::atomic<value_type*> value;
+		};
+
+		std::vector<Slot> mSlots;
+
+		size_t mMask;
+	};
+
+	Table* grow_(Table* table)
+		{
+		boost::shared_ptr<Table> newTable(new Table(table->slotCount() * 2));
+
+		table->copyInto(*newTable);
+
+		mTables.push_back(newTable);
+
+		mCurrentTable.store(newTable.get(), std::memory_order_release);
+
+		return newTable.get();
+		}
+
+	std::atomic<Table*> mCurrentTable;
+
+	//every table we've ever published, since readers may still hold old ones
+	std::vector<boost::shared_ptr<Table> > mTables;
+
+	size_t mSize;
+
+	mutable boost::recursive_mutex mWriteMutex;
+};
+
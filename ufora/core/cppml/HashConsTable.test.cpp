@@ -0,0 +1,206 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "HashConsTable.hpp"
+#include "../UnitTest.hpp"
+#include "../Clock.hpp"
+#include "../Logging.hpp"
+#include <boost/unordered_map.hpp>
+#include <functional>
+
+namespace {
+
+class Interned {
+public:
+	Interned(long inValue) : value(inValue)
+		{
+		}
+
+	long value;
+};
+
+//the pre-HashConsTable memoization strategy: unordered_maps behind
+//recursive mutexes, striped by the low bits of the hash
+class LockedStripedTable {
+public:
+	const static int slice_count = 32;
+
+	template<class factory_type>
+	Interned* findOrCreate(const hash_type& hash, const factory_type& factory)
+		{
+		int sliceIndex = hash[0] % slice_count;
+
+		boost::recursive_mutex::scoped_lock lock(mMutexes[sliceIndex]);
+
+		auto it = mTables[sliceIndex].find(hash);
+
+		if (it != mTables[sliceIndex].end())
+			return it->second;
+
+		Interned* result = factory();
+
+		mTables[sliceIndex][hash] = result;
+
+		return result;
+		}
+
+private:
+	boost::recursive_mutex mMutexes[slice_count];
+
+	boost::unordered_map<hash_type, Interned*> mTables[slice_count];
+};
+
+class StripedHashConsTable {
+public:
+	const static int slice_count = 32;
+
+	template<class factory_type>
+	Interned* findOrCreate(const hash_type& hash, const factory_type& factory)
+		{
+		return mTables[hash[0] % slice_count].findOrCreate(hash, factory);
+		}
+
+private:
+	HashConsTable<Interned> mTables[slice_count];
+};
+
+template<class table_type>
+double timeConcurrentLookups(table_type& table, long threadCount, long keyCount, long lookupsPerThread)
+	{
+	std::vector<hash_type> keys;
+
+	for (long k = 0; k < keyCount; k++)
+		keys.push_back(hashValue(k));
+
+	//populate up front so we measure the hit path, which dominates in practice
+	for (long k = 0; k < keyCount; k++)
+		table.findOrCreate(keys[k], [&]() { return new Interned(k); });
+
+	double t0 = curClock();
+
+	boost::thread_group threads;
+
+	for (long t = 0; t < threadCount; t++)
+		threads.create_thread([&, t]() {
+			for (long k = 0; k < lookupsPerThread; k++)
+				{
+				long index = (k * 7919 + t) % keyCount;
+
+				Interned* value = table.findOrCreate(
+					keys[index],
+					[&]() { return (Interned*)0; }
+					);
+
+				lassert(value && value->value == index);
+				}
+			});
+
+	threads.join_all();
+
+	return curClock() - t0;
+	}
+
+}
+
+BOOST_AUTO_TEST_SUITE( test_HashConsTable )
+
+BOOST_AUTO_TEST_CASE( test_find_and_create )
+	{
+	HashConsTable<Interned> table;
+
+	BOOST_CHECK(table.find(hashValue(1)) == 0);
+
+	std::vector<Interned*> values;
+
+	//enough to force several rounds of growth
+	for (long k = 0; k < 10000; k++)
+		values.push_back(table.findOrCreate(hashValue(k), [&]() { return new Interned(k); }));
+
+	BOOST_CHECK_EQUAL(table.size(), 10000);
+
+	for (long k = 0; k < 10000; k++)
+		{
+		BOOST_CHECK(table.find(hashValue(k)) == values[k]);
+		BOOST_CHECK(table.findOrCreate(hashValue(k), [&]() { return new Interned(-1); }) == values[k]);
+		}
+
+	BOOST_CHECK_EQUAL(table.size(), 10000);
+	}
+
+BOOST_AUTO_TEST_CASE( test_factory_may_reenter )
+	{
+	HashConsTable<Interned> table;
+
+	//each value's factory interns the value below it, growing the table while
+	//the outer insertion is still pending
+	std::function<Interned* (long)> intern = [&](long k) {
+		return table.findOrCreate(hashValue(k), [&]() {
+			if (k > 0)
+				intern(k - 1);
+			return new Interned(k);
+			});
+		};
+
+	Interned* top = intern(500);
+
+	BOOST_CHECK_EQUAL(top->value, 500);
+	BOOST_CHECK_EQUAL(table.size(), 501);
+
+	for (long k = 0; k <= 500; k++)
+		BOOST_CHECK_EQUAL(table.find(hashValue(k))->value, k);
+	}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_creation_is_unique )
+	{
+	HashConsTable<Interned> table;
+
+	const long keyCount = 5000;
+
+	std::vector<std::vector<Interned*> > seen(8, std::vector<Interned*>(keyCount));
+
+	boost::thread_group threads;
+
+	for (long t = 0; t < seen.size(); t++)
+		threads.create_thread([&, t]() {
+			for (long k = 0; k < keyCount; k++)
+				seen[t][k] = table.findOrCreate(hashValue(k), [&]() { return new Interned(k); });
+			});
+
+	threads.join_all();
+
+	BOOST_CHECK_EQUAL(table.size(), keyCount);
+
+	for (long t = 1; t < seen.size(); t++)
+		BOOST_CHECK(seen[t] == seen[0]);
+	}
+
+BOOST_AUTO_TEST_CASE( test_benchmark_against_locked_tables )
+	{
+	for (long threadCount: {1, 4, 16})
+		{
+		LockedStripedTable locked;
+		StripedHashConsTable lockFree;
+
+		double lockedTime = timeConcurrentLookups(locked, threadCount, 10000, 1000000);
+		double lockFreeTime = timeConcurrentLookups(lockFree, threadCount, 10000, 1000000);
+
+		LOG_INFO << "HashConsTable benchmark with " << threadCount << " threads: "
+			<< "locked tables took " << lockedTime << ", "
+			<< "HashConsTable took " << lockFreeTime;
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -17,6 +17,7 @@
 #include "../cppml/CPPMLPrettyPrinter.hppml"
 #include "../../third_party/cityhash/city.hpp"
 #include <openssl/sha.h>
+#include <atomic>
 
 Hash Hash::SHA1(const void* data, uint32_t sz)
 	{
@@ -35,7 +36,7 @@ Hash Hash::SHA1Strided(
 			uint32_t inCount
 			)
 	{
-	if (inBlockStride == inBlockStride)
+	if (inBlockSize == inBlockStride)
 		return SHA1(data, inBlockSize * inCount);
 
 	SHA_CTX ctx;
@@ -192,3 +193,185 @@ Hash Hash::CityHash(const void* data, uint32_t sz)
 	return newHash;
 	}
 
+namespace {
+
+//read on every content hash, from any thread
+std::atomic<Hash::ContentHashBackend> sContentHashBackend(Hash::ContentHashBackend::CityTree);
+
+//hash 'leafCount' whole leaves. This stays on the calling thread: content hashes are taken
+//from many worker threads at once, so there's little to gain from fanning a single buffer out.
+void hashLeaves(const char* data, size_t leafCount, Hash* outHashes)
+	{
+	for (size_t k = 0; k < leafCount; k++)
+		outHashes[k] = Hash::CityHash(
+			data + k * ContentHasher::kLeafBytes,
+			ContentHasher::kLeafBytes
+			);
+	}
+
+}
+
+void Hash::setContentHashBackend(ContentHashBackend inBackend)
+	{
+	sContentHashBackend.store(inBackend);
+	}
+
+Hash::ContentHashBackend Hash::contentHashBackend()
+	{
+	return sContentHashBackend.load();
+	}
+
+Hash Hash::content(const void* data, size_t sz)
+	{
+	if (contentHashBackend() == ContentHashBackend::SHA1)
+		{
+		ContentHasher hasher;
+		hasher.update(data, sz);
+		return hasher.finish();
+		}
+
+	//matches what ContentHasher produces for a single partial leaf
+	if (sz <= ContentHasher::kLeafBytes)
+		return CityHash(data, sz);
+
+	ContentHasher hasher;
+	hasher.update(data, sz);
+	return hasher.finish();
+	}
+
+Hash Hash::contentStrided(
+			const void* data,
+			uint32_t inBlockSize,
+			uint32_t inBlockStride,
+			uint32_t inCount
+			)
+	{
+	if (inBlockSize == inBlockStride)
+		return content(data, (size_t)inBlockSize * inCount);
+
+	ContentHasher hasher;
+
+	const uint8_t* dataAsInt = (const uint8_t*) data;
+
+	for (long k = 0; k < inCount; k++)
+		hasher.update(dataAsInt + (size_t)inBlockStride * k, inBlockSize);
+
+	return hasher.finish();
+	}
+
+Hash Hash::contentScattered(
+			const void** data,
+			uint32_t inBlockSize,
+			uint32_t inBlockNudge,
+			uint32_t inCount
+			)
+	{
+	ContentHasher hasher;
+
+	for (long k = 0; k < inCount; k++)
+		hasher.update((const uint8_t*)data[k] + inBlockNudge, inBlockSize);
+
+	return hasher.finish();
+	}
+
+const size_t ContentHasher::kLeafBytes;
+
+ContentHasher::ContentHasher() :
+		mBackend(Hash::contentHashBackend()),
+		mSha1Context(0),
+		mLeafCount(0),
+		mTotalBytes(0)
+	{
+	if (mBackend == Hash::ContentHashBackend::SHA1)
+		{
+		mSha1Context = new SHA_CTX;
+		SHA1_Init((SHA_CTX*)mSha1Context);
+		}
+	}
+
+ContentHasher::~ContentHasher()
+	{
+	delete (SHA_CTX*)mSha1Context;
+	}
+
+void ContentHasher::foldLeaf(const Hash& leafHash)
+	{
+	mFolded = mFolded + leafHash;
+	mLeafCount++;
+	}
+
+void ContentHasher::update(const void* data, size_t sz)
+	{
+	mTotalBytes += sz;
+
+	if (mSha1Context)
+		{
+		if (sz)
+			SHA1_Update((SHA_CTX*)mSha1Context, data, sz);
+		return;
+		}
+
+	const char* bytes = (const char*)data;
+
+	//top up a partially filled leaf first
+	if (mPendingLeaf.size())
+		{
+		size_t toCopy = std::min(sz, kLeafBytes - mPendingLeaf.size());
+
+		mPendingLeaf.append(bytes, toCopy);
+		bytes += toCopy;
+		sz -= toCopy;
+
+		//a full leaf is only folded once we know more data follows it
+		if (sz == 0)
+			return;
+
+		foldLeaf(Hash::CityHash(mPendingLeaf.data(), kLeafBytes));
+		mPendingLeaf.clear();
+		}
+
+	//whole leaves can be hashed straight out of the caller's buffer. We hold
+	//back the final leaf if nothing follows it, so that data fitting in a
+	//single leaf always hashes the same way.
+	size_t wholeLeaves = sz / kLeafBytes;
+
+	if (wholeLeaves && wholeLeaves * kLeafBytes == sz)
+		wholeLeaves--;
+
+	if (wholeLeaves)
+		{
+		std::vector<Hash> leafHashes(wholeLeaves);
+
+		hashLeaves(bytes, wholeLeaves, &leafHashes[0]);
+
+		for (long k = 0; k < leafHashes.size(); k++)
+			foldLeaf(leafHashes[k]);
+
+		bytes += wholeLeaves * kLeafBytes;
+		sz -= wholeLeaves * kLeafBytes;
+		}
+
+	mPendingLeaf.append(bytes, sz);
+	}
+
+Hash ContentHasher::finish()
+	{
+	if (mSha1Context)
+		{
+		Hash tr;
+		SHA1_Final((unsigned char*)&tr, (SHA_CTX*)mSha1Context);
+		SHA1_Init((SHA_CTX*)mSha1Context);
+		return tr;
+		}
+
+	if (mLeafCount == 0)
+		return Hash::CityHash(mPendingLeaf.data(), mPendingLeaf.size());
+
+	if (mPendingLeaf.size())
+		{
+		foldLeaf(Hash::CityHash(mPendingLeaf.data(), mPendingLeaf.size()));
+		mPendingLeaf.clear();
+		}
+
+	return mFolded + Hash((uint32_t)mTotalBytes, (uint32_t)(mTotalBytes >> 32));
+	}
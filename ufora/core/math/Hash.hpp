@@ -147,10 +147,83 @@ public:
 			uint32_t inCount
 			);
 
+		//Content hashes identify bulk data (pages, arrays, serialized blobs) by
+		//value. They are not cryptographic: use SHA1 anywhere an adversary might
+		//choose the input. The result depends only on the bytes hashed, not on
+		//how they were split up across calls, so 'contentStrided' and
+		//'contentScattered' agree with 'content' over the gathered bytes.
+		enum class ContentHashBackend {
+			//SHA1 over the whole stream. Slow, but kept for comparison.
+			SHA1,
+			//CityHash over 64k leaves, folded together in order.
+			CityTree
+		};
+
+		//every process that exchanges content hashes must use the same backend, so
+		//set this once at startup, before any threads start hashing
+		static void setContentHashBackend(ContentHashBackend inBackend);
+
+		static ContentHashBackend contentHashBackend();
+
+		static Hash content(const void* data, size_t sz);
+
+		static Hash contentStrided(
+			const void* data,
+			uint32_t inBlockSize,
+			uint32_t inBlockStride,
+			uint32_t inCount
+			);
+
+		static Hash contentScattered(
+			const void** data,
+			uint32_t inBlockSize,
+			uint32_t inBlockNudge,
+			uint32_t inCount
+			);
+
 private:
 		uint32_t mData[5];
 };
 
+//incrementally computes Hash::content over a sequence of byte ranges
+class ContentHasher {
+public:
+		ContentHasher();
+
+		~ContentHasher();
+
+		void update(const void* data, size_t sz);
+
+		template<class T>
+		void updateRaw(const T& in)
+			{
+			update(&in, sizeof(T));
+			}
+
+		Hash finish();
+
+		const static size_t kLeafBytes = 64 * 1024;
+
+private:
+		ContentHasher(const ContentHasher&);
+
+		ContentHasher& operator=(const ContentHasher&);
+
+		void foldLeaf(const Hash& leafHash);
+
+		Hash::ContentHashBackend mBackend;
+
+		void* mSha1Context;
+
+		std::string mPendingLeaf;
+
+		Hash mFolded;
+
+		uint64_t mLeafCount;
+
+		uint64_t mTotalBytes;
+};
+
 template<class T>
 Hash hashRaw(const T& in)
 	{
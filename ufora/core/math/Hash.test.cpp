@@ -36,5 +36,132 @@ BOOST_AUTO_TEST_CASE( test_HashToString )
 	checkStringHash(Hash::SHA1("hello"));
 	}
 
+namespace {
+
+std::string pseudorandomBytes(size_t count)
+	{
+	std::string result;
+	result.resize(count);
+
+	uint32_t state = 12345;
+	for (size_t k = 0; k < count; k++)
+		{
+		state = state * 1103515245 + 12345;
+		result[k] = state >> 16;
+		}
+
+	return result;
+	}
+
+Hash contentHashInPieces(const std::string& data, size_t pieceSize)
+	{
+	ContentHasher hasher;
+
+	for (size_t low = 0; low < data.size(); low += pieceSize)
+		hasher.update(data.data() + low, std::min(pieceSize, data.size() - low));
+
+	return hasher.finish();
+	}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_ContentHashIndependentOfSplitting )
+	{
+	size_t sizes[] = {
+		0,
+		1,
+		ContentHasher::kLeafBytes - 1,
+		ContentHasher::kLeafBytes,
+		ContentHasher::kLeafBytes + 1,
+		ContentHasher::kLeafBytes * 3,
+		//large enough to be hashed in parallel when contiguous
+		ContentHasher::kLeafBytes * 200 + 17
+		};
+
+	for (auto size: sizes)
+		{
+		std::string data = pseudorandomBytes(size);
+
+		Hash whole = Hash::content(data.data(), data.size());
+
+		BOOST_CHECK(whole == contentHashInPieces(data, 1000));
+		BOOST_CHECK(whole == contentHashInPieces(data, ContentHasher::kLeafBytes));
+		BOOST_CHECK(whole == contentHashInPieces(data, ContentHasher::kLeafBytes * 7 + 3));
+
+		if (size)
+			{
+			std::string modified = data;
+			modified[size / 2]++;
+
+			BOOST_CHECK(whole != Hash::content(modified.data(), modified.size()));
+			}
+		}
+	}
+
+BOOST_AUTO_TEST_CASE( test_ContentHashStridedAndScattered )
+	{
+	const uint32_t blockSize = 12;
+	const uint32_t stride = 20;
+	const uint32_t count = 10000;
+
+	std::string strided = pseudorandomBytes(stride * count);
 
+	std::string packed;
+	std::vector<const void*> pointers;
+
+	for (long k = 0; k < count; k++)
+		{
+		packed.append(strided, k * stride + 4, blockSize);
+		pointers.push_back(strided.data() + k * stride);
+		}
+
+	Hash expected = Hash::content(packed.data(), packed.size());
+
+	BOOST_CHECK(expected == Hash::contentStrided(strided.data() + 4, blockSize, stride, count));
+	BOOST_CHECK(expected == Hash::contentScattered(&pointers[0], blockSize, 4, count));
+	}
+
+BOOST_AUTO_TEST_CASE( test_SHA1Strided )
+	{
+	std::string data = pseudorandomBytes(100);
+
+	std::string packed;
+	for (long k = 0; k < 10; k++)
+		packed.append(data, k * 10, 4);
+
+	BOOST_CHECK(Hash::SHA1Strided(data.data(), 4, 10, 10) == Hash::SHA1(packed));
+	}
+
+BOOST_AUTO_TEST_CASE( test_ContentHashSHA1Backend )
+	{
+	std::string data = pseudorandomBytes(ContentHasher::kLeafBytes * 2 + 5);
+
+	Hash::setContentHashBackend(Hash::ContentHashBackend::SHA1);
+
+	Hash viaSha1 = Hash::content(data.data(), data.size());
+	Hash viaSha1InPieces = contentHashInPieces(data, 999);
+
+	Hash::setContentHashBackend(Hash::ContentHashBackend::CityTree);
+
+	BOOST_CHECK(viaSha1 == Hash::SHA1(data));
+	BOOST_CHECK(viaSha1InPieces == viaSha1);
+	BOOST_CHECK(Hash::content(data.data(), data.size()) != viaSha1);
+	}
+
+BOOST_AUTO_TEST_CASE( test_ContentHashThroughput )
+	{
+	std::string data = pseudorandomBytes(64 * 1024 * 1024);
+
+	double t0 = curClock();
+	Hash sha1 = Hash::SHA1(data);
+	double sha1Time = curClock() - t0;
+
+	t0 = curClock();
+	Hash content = Hash::content(data.data(), data.size());
+	double contentTime = curClock() - t0;
+
+	LOG_INFO << "Hashing 64 MB: SHA1 took " << sha1Time << ", content hash took " << contentTime;
+
+	BOOST_CHECK(sha1 != content);
+	}
 
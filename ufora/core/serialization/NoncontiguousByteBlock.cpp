@@ -50,9 +50,9 @@ void NoncontiguousByteBlock::push_back(std::string&& inString)
 		}
 	else
 		{
-		mStrings.push_back(inString);
-
 		mTotalBytes += inString.size();
+
+		mStrings.push_back(std::move(inString));
 		}
 	}
 
@@ -105,7 +105,14 @@ void NoncontiguousByteBlock::clear(void)
 hash_type NoncontiguousByteBlock::hash() const
 	{
 	if (!mHash)
-		mHash = hashValue(toString());
+		{
+		ContentHasher hasher;
+
+		for (const auto& str : mStrings)
+			hasher.update(str.data(), str.size());
+
+		mHash = hasher.finish();
+		}
 
 	return *mHash;
 	}
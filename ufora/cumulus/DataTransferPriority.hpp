@@ -0,0 +1,64 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace Cumulus {
+
+/****************
+
+DataTransferPriority
+
+Priority classes for DataTransfers::scheduleLargeMessage. Higher values are sent first.
+
+Classes at or above 'LatencyCritical' are sent strictly ahead of everything else and
+may use the part of the outstanding-byte threshold that is held back from bulk traffic.
+Classes below it share what's left, with the lowest classes guaranteed not to be
+starved completely.
+
+*****************/
+
+namespace DataTransferPriority {
+
+//checkpoint and persistence traffic, and data sent back to clients
+const static int64_t Bulk = 0;
+
+//computation results and computation moves between workers
+const static int64_t Computation = 1;
+
+//pages that computations are blocked on
+const static int64_t PageLoad = 2;
+
+const static int64_t LatencyCritical = PageLoad;
+
+inline std::string name(int64_t priority)
+	{
+	if (priority == Bulk)
+		return "bulk";
+	if (priority == Computation)
+		return "computation";
+	if (priority == PageLoad)
+		return "pageLoad";
+
+	return "priority" + std::to_string((long long)priority);
+	}
+
+}
+
+}
+
@@ -0,0 +1,135 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+namespace Cumulus {
+
+/****************
+
+LinkThroughput
+
+Estimates the bandwidth of the link to one endpoint from the transfers acknowledged on it.
+
+Bytes are counted across every transfer on the link, over the time the link had at least one
+transfer outstanding. N transfers sharing a link each take about N times longer than one would
+alone, so measuring them one at a time would see a tenth of the bandwidth with ten in flight.
+Counting them together sees the whole link, and idle time between bursts doesn't count at all.
+
+Once a window has at least 'windowSeconds' of busy time, the bytes acknowledged in it become a
+new measurement, which is folded into a moving average with weight 'observationWeight'. We close
+windows when the link drains, so that transfers that were in flight together all count towards
+the same one. A link that never drains closes its window after twice that.
+
+*****************/
+
+class LinkThroughput {
+public:
+	LinkThroughput(double windowSeconds, double observationWeight) :
+			mWindowSeconds(windowSeconds),
+			mObservationWeight(observationWeight),
+			mTransfersInFlight(0),
+			mBusySince(0),
+			mBusySecondsInWindow(0),
+			mBytesInWindow(0),
+			mHasEstimate(false),
+			mBytesPerSecond(0)
+		{
+		}
+
+	void transferStarted(double curTime)
+		{
+		if (!mTransfersInFlight)
+			mBusySince = curTime;
+
+		mTransfersInFlight++;
+		}
+
+	void transferAcknowledged(int64_t bytes, double curTime)
+		{
+		mBytesInWindow += bytes;
+
+		if (mTransfersInFlight > 0)
+			{
+			mTransfersInFlight--;
+
+			if (!mTransfersInFlight)
+				mBusySecondsInWindow += curTime - mBusySince;
+			}
+
+		double busySeconds = busySecondsInWindow(curTime);
+
+		if (busySeconds < mWindowSeconds ||
+				(mTransfersInFlight && busySeconds < mWindowSeconds * 2))
+			return;
+
+		double observed = mBytesInWindow / busySeconds;
+
+		if (!mHasEstimate)
+			mBytesPerSecond = observed;
+		else
+			mBytesPerSecond += (observed - mBytesPerSecond) * mObservationWeight;
+
+		mHasEstimate = true;
+
+		mBytesInWindow = 0;
+		mBusySecondsInWindow = 0;
+		mBusySince = curTime;
+		}
+
+	bool hasEstimate() const
+		{
+		return mHasEstimate;
+		}
+
+	double bytesPerSecond() const
+		{
+		return mBytesPerSecond;
+		}
+
+	long transfersInFlight() const
+		{
+		return mTransfersInFlight;
+		}
+
+private:
+	double busySecondsInWindow(double curTime) const
+		{
+		if (mTransfersInFlight)
+			return mBusySecondsInWindow + (curTime - mBusySince);
+
+		return mBusySecondsInWindow;
+		}
+
+	double mWindowSeconds;
+
+	double mObservationWeight;
+
+	long mTransfersInFlight;
+
+	double mBusySince;
+
+	double mBusySecondsInWindow;
+
+	int64_t mBytesInWindow;
+
+	bool mHasEstimate;
+
+	double mBytesPerSecond;
+};
+
+}
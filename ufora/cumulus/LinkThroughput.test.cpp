@@ -0,0 +1,101 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "LinkThroughput.hpp"
+#include "../core/UnitTest.hpp"
+
+using Cumulus::LinkThroughput;
+
+BOOST_AUTO_TEST_SUITE( test_Cumulus_LinkThroughput )
+
+BOOST_AUTO_TEST_CASE( test_no_estimate_until_a_window_has_passed )
+	{
+	LinkThroughput link(1.0, 0.25);
+
+	link.transferStarted(0.0);
+	link.transferAcknowledged(1000, 0.5);
+
+	BOOST_CHECK(!link.hasEstimate());
+
+	link.transferStarted(0.5);
+	link.transferAcknowledged(1000, 1.0);
+
+	BOOST_REQUIRE(link.hasEstimate());
+	BOOST_CHECK_CLOSE(link.bytesPerSecond(), 2000.0, 1e-6);
+	}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_transfers_see_the_whole_link )
+	{
+	//ten transfers of 100 bytes share a 1000 byte/second link, so each one takes a second
+	LinkThroughput link(1.0, 0.25);
+
+	for (long k = 0; k < 10; k++)
+		link.transferStarted(0.0);
+
+	for (long k = 0; k < 10; k++)
+		link.transferAcknowledged(100, 1.0);
+
+	BOOST_REQUIRE(link.hasEstimate());
+	BOOST_CHECK_CLOSE(link.bytesPerSecond(), 1000.0, 1e-6);
+	BOOST_CHECK_EQUAL(link.transfersInFlight(), 0);
+	}
+
+BOOST_AUTO_TEST_CASE( test_idle_time_doesnt_count )
+	{
+	LinkThroughput link(1.0, 0.25);
+
+	link.transferStarted(0.0);
+	link.transferAcknowledged(500, 0.5);
+
+	//the link sits idle for a long time between these
+	link.transferStarted(100.0);
+	link.transferAcknowledged(500, 100.5);
+
+	BOOST_REQUIRE(link.hasEstimate());
+	BOOST_CHECK_CLOSE(link.bytesPerSecond(), 1000.0, 1e-6);
+	}
+
+BOOST_AUTO_TEST_CASE( test_busy_link_still_measures )
+	{
+	//a link that always has something in flight
+	LinkThroughput link(1.0, 0.25);
+
+	link.transferStarted(0.0);
+
+	for (long k = 1; k <= 4; k++)
+		{
+		link.transferStarted(k * 0.5);
+		link.transferAcknowledged(500, k * 0.5);
+		}
+
+	BOOST_REQUIRE(link.hasEstimate());
+	BOOST_CHECK_CLOSE(link.bytesPerSecond(), 1000.0, 1e-6);
+	}
+
+BOOST_AUTO_TEST_CASE( test_estimate_moves_towards_new_measurements )
+	{
+	LinkThroughput link(1.0, 0.25);
+
+	link.transferStarted(0.0);
+	link.transferAcknowledged(1000, 1.0);
+
+	link.transferStarted(1.0);
+	link.transferAcknowledged(5000, 2.0);
+
+	BOOST_CHECK_CLOSE(link.bytesPerSecond(), 2000.0, 1e-6);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -177,6 +177,36 @@ class TestPersistentCacheIndex(unittest.TestCase):
             self.assertEqual(view.totalBytesInCache(), 10)
 
 
+    @ComputedGraphTestHarness.UnderHarness
+    def test_runtimePredictionsArePersisted(self):
+        cppView1 = CumulusNative.PersistentCacheIndex(
+            self.sharedState.newView(),
+            callbackScheduler
+            )
+
+        cppView2 = CumulusNative.PersistentCacheIndex(
+            self.sharedState.newView(),
+            callbackScheduler
+            )
+
+        self.assertTrue(cppView1.predictedRuntime(sha1("shape")) is None)
+
+        cppView1.addRuntimeObservation(sha1("shape"), 10.0)
+        cppView1.addRuntimeObservation(sha1("shape"), 20.0)
+
+        self.assertEqual(cppView1.predictedRuntime(sha1("shape")), 15.0)
+
+        #observations are batched, so the other view only sees them once they're flushed
+        cppView1.flushRuntimeObservations()
+
+        self.waitForSync(lambda: cppView2.predictedRuntime(sha1("shape")) is not None)
+
+        self.assertEqual(cppView2.predictedRuntime(sha1("shape")), 15.0)
+
+        #runtime predictions don't occupy space in the cache and are never garbage
+        self.assertEqual(cppView1.totalBytesInCache(), 0)
+        self.assertEqual(len(cppView1.computeInvalidObjects()), 0)
+
     @ComputedGraphTestHarness.UnderHarness
     def test_writing_while_disconnected(self):
         currentView = [self.sharedState.newView()]
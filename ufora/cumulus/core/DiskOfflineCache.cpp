@@ -17,7 +17,9 @@
 
 #include "DiskOfflineCache.hpp"
 #include "../../core/math/Hash.hpp"
+#include "../../core/Clock.hpp"
 #include "../../core/Logging.hpp"
+#include "../../core/Metrics.hpp"
 #include "../../core/threading/CallbackScheduler.hppml"
 #include "../../core/math/Nullable.hpp"
 #include "../../core/Memory.hpp"
@@ -131,6 +133,13 @@ void DiskOfflineCache::store(
 		mPagesBeingWritten[inDataID] = inSerializedData;
 		}
 
+	static Ufora::metrics::Histogram& storeLatency =
+		Ufora::metrics::histogram("diskOfflineCache.store_us");
+	static Ufora::metrics::Counter& bytesStored =
+		Ufora::metrics::counter("diskOfflineCache.bytesStored");
+
+	double t0 = curClock();
+
 	boost::filesystem::path datPath(pathFor(inDataID));
 
 	lassert_dump(!boost::filesystem::exists(datPath), datPath);
@@ -166,6 +175,9 @@ void DiskOfflineCache::store(
 		bytesWritten = protocol.position();
 		}
 
+	storeLatency.recordSeconds(curClock() - t0);
+	bytesStored.add(bytesWritten);
+
 		{
 		boost::recursive_mutex::scoped_lock		lock(mMutex);
 
@@ -243,6 +255,13 @@ PolymorphicSharedPtr<SerializedObject> DiskOfflineCache::loadIfExists(const Fora
 			mPagesBeingRead.insert(inID);
 		}
 
+	static Ufora::metrics::Histogram& loadLatency =
+		Ufora::metrics::histogram("diskOfflineCache.load_us");
+	static Ufora::metrics::Counter& bytesLoaded =
+		Ufora::metrics::counter("diskOfflineCache.bytesLoaded");
+
+	double t0 = curClock();
+
 	boost::filesystem::path datPath(pathFor(inID));
 
 	lassert_dump(boost::filesystem::exists(datPath), datPath);
@@ -278,6 +297,9 @@ PolymorphicSharedPtr<SerializedObject> DiskOfflineCache::loadIfExists(const Fora
 
 	mTotalBytesLoaded += protocol.position();
 
+	loadLatency.recordSeconds(curClock() - t0);
+	bytesLoaded.add(protocol.position());
+
 		{
 		boost::recursive_mutex::scoped_lock		lock(mMutex);
 
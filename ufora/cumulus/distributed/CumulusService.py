@@ -98,6 +98,8 @@ class CumulusService(Stoppable.Stoppable):
         Runtime.initialize()
         ModuleImporter.initialize()
 
+        config.configureMetricsExport()
+
         self.cumulusActiveMachines = CumulusActiveMachines.CumulusActiveMachines(
             self.viewFactory
             )
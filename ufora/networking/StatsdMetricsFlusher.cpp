@@ -0,0 +1,65 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#include "StatsdMetricsFlusher.hpp"
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace ufora {
+
+StatsdMetricsFlusher::StatsdMetricsFlusher(const std::string& component) :
+        mStatsd(component)
+    {
+    }
+
+void StatsdMetricsFlusher::flush(const Ufora::metrics::MetricsSnapshot& snapshot)
+    {
+    for (const auto& nameAndValue: snapshot.counters)
+        {
+        int64_t& previous = mPreviousCounters[nameAndValue.first];
+
+        if (nameAndValue.second > previous)
+            mStatsd.increment(nameAndValue.first, nameAndValue.second - previous);
+
+        previous = nameAndValue.second;
+        }
+
+    for (const auto& nameAndValue: snapshot.gauges)
+        mStatsd.gauge(nameAndValue.first, nameAndValue.second);
+
+    for (const auto& nameAndHistogram: snapshot.histograms)
+        {
+        const Ufora::metrics::HistogramSnapshot& histogram = nameAndHistogram.second;
+
+        if (!histogram.count)
+            continue;
+
+        mStatsd.gauge(nameAndHistogram.first + ".p50", histogram.quantile(0.5));
+        mStatsd.gauge(nameAndHistogram.first + ".p99", histogram.quantile(0.99));
+        mStatsd.gauge(nameAndHistogram.first + ".max", histogram.maxValue());
+        }
+    }
+
+void StatsdMetricsFlusher::install(const std::string& component)
+    {
+    boost::shared_ptr<StatsdMetricsFlusher> flusher(new StatsdMetricsFlusher(component));
+
+    Ufora::metrics::addSnapshotListener(
+        boost::bind(&StatsdMetricsFlusher::flush, flusher, _1)
+        );
+    }
+
+}
+
@@ -0,0 +1,51 @@
+/***************************************************************************
+   Copyright 2015 Ufora Inc.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+****************************************************************************/
+#pragma once
+
+#include "../core/Metrics.hpp"
+#include <boost/thread.hpp>
+#include <map>
+#include <string>
+#include "statsd.hpp"
+
+namespace ufora {
+
+/****
+Forwards in-process metrics snapshots to statsd.
+
+Counters are sent as the change since the previous snapshot, gauges as-is, and
+each histogram as p50/p99/max gauges. This replaces a UDP packet per event with
+a handful of packets per export interval.
+****/
+
+class StatsdMetricsFlusher
+{
+public:
+    explicit StatsdMetricsFlusher(const std::string& component);
+
+    void flush(const Ufora::metrics::MetricsSnapshot& snapshot);
+
+    //register a flusher as a metrics snapshot listener
+    static void install(const std::string& component);
+
+private:
+    Statsd mStatsd;
+
+    std::map<std::string, int64_t> mPreviousCounters;
+};
+
+}
+
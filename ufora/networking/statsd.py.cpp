@@ -13,7 +13,7 @@
    See the License for the specific language governing permissions and
    limitations under the License.
 ****************************************************************************/
-#include "statsd.hpp"
+#include "StatsdMetricsFlusher.hpp"
 
 #include "../native/Registrar.hpp"
 #include <boost/python.hpp>
@@ -82,6 +82,8 @@ public:
                         args("prefix")
                         )
                     );
+
+        def("installMetricsFlusher", &StatsdMetricsFlusher::install);
         }
 };
 